@@ -1,5 +1,5 @@
 # 迷宫生成与路径搜索项目
-QT += core gui widgets
+QT += core gui widgets network
 
 # C++ 标准配置
 CONFIG += c++17
@@ -12,11 +12,46 @@ QT_PATCH_VERSION = 3
 # 源文件
 SOURCES += \
     main.cpp \
-    mainwindow.cpp
+    batchrunner.cpp \
+    compactpath.cpp \
+    componentlabels.cpp \
+    goalset.cpp \
+    jsonlines.cpp \
+    latencyhistogram.cpp \
+    loadgenerator.cpp \
+    mainwindow.cpp \
+    mazegenerator.cpp \
+    mazeio.cpp \
+    multiagentplanner.cpp \
+    pagedsolver.cpp \
+    pathcache.cpp \
+    pathsolver.cpp \
+    pathtrie.cpp \
+    solverservice.cpp \
+    tiledgrid.cpp \
+    tiledrunner.cpp
 
 # 头文件
 HEADERS += \
-    mainwindow.h
+    batchrunner.h \
+    compactpath.h \
+    componentlabels.h \
+    goalset.h \
+    jsonlines.h \
+    latencyhistogram.h \
+    loadgenerator.h \
+    mainwindow.h \
+    mazegenerator.h \
+    mazegrid.h \
+    mazeio.h \
+    multiagentplanner.h \
+    pagedsolver.h \
+    pathcache.h \
+    pathsolver.h \
+    pathtrie.h \
+    solverservice.h \
+    tiledgrid.h \
+    tiledrunner.h
 
 # UI 文件
 FORMS += \
@@ -0,0 +1,326 @@
+#include "batchrunner.h"
+
+#include "compactpath.h"
+#include "componentlabels.h"
+#include "goalset.h"
+#include "jsonlines.h"
+#include "mazegenerator.h"
+#include "mazegrid.h"
+#include "mazeio.h"
+#include "pathsolver.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+#include <algorithm>          // std::min, std::sort, std::unique, std::binary_search
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+const char *const BatchRunner::kFlag = "--batch";
+
+namespace {
+
+// 一个查询的求解结果
+struct QueryResult {
+    bool found = false;
+    bool invalid = false;  // 起点或终点越界或是墙壁，未搜索
+    bool rejected = false; // 起终点不连通，未搜索
+    int goal = -1;         // 最近目标模式下到达的目标下标
+    qint64 expanded = 0;
+    qint64 elapsedNs = 0;
+    CompactPath path;
+};
+
+// 读取目标点文件：每行 "x y"
+bool readGoals(const QString &fileName, QVector<QPoint> &goals, QString &error) {
+    return readNumberLines(fileName, "目标点文件", {2}, [&](const QVector<int> &v) {
+        goals.append(QPoint(v[0], v[1]));
+    }, error);
+}
+
+// 全部通路单元格
+QVector<QPoint> openCells(const MazeView &view) {
+    QVector<QPoint> cells;
+    for (int y = 0; y < view.rows; ++y)
+        for (int x = 0; x < view.cols; ++x)
+            if (view.isOpen(x, y))
+                cells.append(QPoint(x, y));
+    return cells;
+}
+
+// 在通路单元格中随机生成查询
+void randomQueries(const MazeView &view, int count, quint32 seed, QVector<Query> &queries) {
+    const QVector<QPoint> cells = openCells(view);
+    if (cells.isEmpty()) return;
+
+    QRandomGenerator rng(seed);
+    for (int i = 0; i < count; ++i) {
+        Query q;
+        q.start = cells[rng.bounded(static_cast<int>(cells.size()))];
+        q.end = cells[rng.bounded(static_cast<int>(cells.size()))];
+        queries.append(q);
+    }
+}
+
+// 在通路单元格中随机生成目标点
+void randomGoals(const MazeView &view, int count, quint32 seed, QVector<QPoint> &goals) {
+    const QVector<QPoint> cells = openCells(view);
+    if (cells.isEmpty()) return;
+
+    QRandomGenerator rng(seed);
+    for (int i = 0; i < count; ++i)
+        goals.append(cells[rng.bounded(static_cast<int>(cells.size()))]);
+}
+
+} // namespace
+
+int BatchRunner::run(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("迷宫寻路批处理模式：结果以 JSON Lines 格式输出到标准输出。");
+    parser.addHelpOption();
+
+    QCommandLineOption batchOption("batch", "进入批处理模式（必须）。");
+    QCommandLineOption generateOption("generate", "生成 <行数>x<列数> 的迷宫（默认 101x101）。", "RxC", "101x101");
+    QCommandLineOption seedOption("seed", "迷宫生成和随机查询的种子。", "n", "1");
+    QCommandLineOption genThreadsOption("gen-threads", "生成迷宫的线程数，0 表示全部硬件线程。", "n", "0");
+    QCommandLineOption loadOption("load", "从文本文件加载迷宫（代替 --generate）。", "file");
+    QCommandLineOption saveOption("save", "把迷宫保存为文本文件。", "file");
+    QCommandLineOption queriesOption("queries", "查询文件，每行 \"sx sy ex ey\"；\"-\" 表示标准输入。", "file");
+    QCommandLineOption randomOption("random-queries", "没有查询文件时随机生成的查询数。", "n", "1000");
+    QCommandLineOption neighborhoodOption("neighborhood", "邻域：4 或 8。", "4|8", "4");
+    QCommandLineOption heuristicOption("heuristic", "启发函数：manhattan、octile 或 zero；8 邻域下 manhattan 改用 octile。", "name", "manhattan");
+    QCommandLineOption threadsOption("threads", "求解线程数，0 表示全部硬件线程。", "n", "1");
+    QCommandLineOption pathsOption("paths", "在结果中输出路径的方向编码串。");
+    QCommandLineOption goalsOption("goals", "目标点文件，每行 \"x y\"；指定后每个查询求到最近目标点的路径，只使用查询的起点。", "file");
+    QCommandLineOption randomGoalsOption("random-goals", "随机生成 n 个目标点（代替 --goals）。", "n");
+    parser.addOptions({batchOption, generateOption, seedOption, genThreadsOption, loadOption, saveOption,
+                       queriesOption, randomOption, neighborhoodOption, heuristicOption, threadsOption, pathsOption,
+                       goalsOption, randomGoalsOption});
+    parser.process(arguments);
+
+    SolverOptions options;
+    if (!parseNeighborhood(parser.value(neighborhoodOption), options.neighborhood))
+        return failWith("--neighborhood 只能是 4 或 8。");
+    if (!parseHeuristic(parser.value(heuristicOption), options.heuristic))
+        return failWith("--heuristic 只能是 manhattan、octile 或 zero。");
+    options = admissibleOptions(options);
+
+    const quint32 seed = parser.value(seedOption).toUInt();
+    int threads = parser.value(threadsOption).toInt();
+    if (threads <= 0) threads = MazeGenerator::defaultThreadCount();
+    const bool printPaths = parser.isSet(pathsOption);
+
+    // ---------- 迷宫 ----------
+    MazeGrid grid;
+    QElapsedTimer timer;
+    timer.start();
+    QJsonObject mazeInfo;
+    mazeInfo["type"] = "maze";
+    if (parser.isSet(loadOption)) {
+        QString error;
+        if (!loadMazeText(parser.value(loadOption), grid, &error))
+            return failWith(error);
+        mazeInfo["source"] = parser.value(loadOption);
+    } else {
+        int r = 0, c = 0;
+        if (!parseMazeSize(parser.value(generateOption), r, c))
+            return failWith("--generate 的格式应为 <行数>x<列数>，且都不小于 3。");
+        grid.resize(r, c);
+        MazeGenerator::generate(grid.data(), r, c, c, seed, parser.value(genThreadsOption).toInt());
+        mazeInfo["source"] = "generate";
+        mazeInfo["seed"] = static_cast<qint64>(seed);
+    }
+    mazeInfo["rows"] = grid.rows;
+    mazeInfo["cols"] = grid.cols;
+    mazeInfo["ms"] = timer.nsecsElapsed() / 1e6;
+    emitLine(mazeInfo);
+
+    if (parser.isSet(saveOption)) {
+        QString error;
+        if (!saveMazeText(parser.value(saveOption), grid.view(), &error))
+            return failWith(error);
+    }
+
+    // ---------- 查询 ----------
+    const MazeView view = grid.view();
+
+    // 标记连通区域，不连通的查询不必搜索
+    timer.restart();
+    ComponentLabels components;
+    components.build(view, threads);
+    QJsonObject componentInfo;
+    componentInfo["type"] = "components";
+    componentInfo["count"] = components.componentCount();
+    componentInfo["ms"] = timer.nsecsElapsed() / 1e6;
+    emitLine(componentInfo);
+
+    QVector<Query> queries;
+    if (parser.isSet(queriesOption)) {
+        QString error;
+        if (!readQueries(parser.value(queriesOption), queries, error, true))
+            return failWith(error);
+    } else {
+        randomQueries(view, parser.value(randomOption).toInt(), seed, queries);
+    }
+
+    // 最近目标模式：目标集合及其空间索引只建立一次，所有线程只读共享
+    const bool nearestMode = parser.isSet(goalsOption) || parser.isSet(randomGoalsOption);
+    QVector<QPoint> goalPoints;
+    if (parser.isSet(goalsOption)) {
+        QString error;
+        if (!readGoals(parser.value(goalsOption), goalPoints, error))
+            return failWith(error);
+    } else if (parser.isSet(randomGoalsOption)) {
+        randomGoals(view, parser.value(randomGoalsOption).toInt(), seed + 1, goalPoints);
+    }
+    const GoalSet goals(view, goalPoints);
+    if (nearestMode) {
+        QJsonObject goalInfo;
+        goalInfo["type"] = "goals";
+        goalInfo["count"] = static_cast<int>(goalPoints.size());
+        goalInfo["valid"] = goals.validCount();
+        emitLine(goalInfo);
+    }
+    // 含有目标的连通区域编号（排序去重），每个查询只需查一次起点所在区域
+    std::vector<int> goalComponents;
+    for (const QPoint &g : goalPoints) {
+        const int c = components.component(view, g);
+        if (c >= 0) goalComponents.push_back(c);
+    }
+    std::sort(goalComponents.begin(), goalComponents.end());
+    goalComponents.erase(std::unique(goalComponents.begin(), goalComponents.end()), goalComponents.end());
+
+    // ---------- 求解 ----------
+    // 多个工作线程各自持有 SolverWorkspace，通过原子计数器领取查询；
+    // 主线程按查询顺序等待结果就绪并立即输出，因此结果是流式的且顺序确定。
+    const int n = queries.size();
+    std::vector<QueryResult> results(n);
+    std::vector<char> ready(n, 0);
+    std::mutex readyMutex;
+    std::condition_variable readyChanged;
+    std::atomic<int> nextQuery(0);
+
+    auto solveOne = [&](int i, SolverWorkspace &ws) {
+        QElapsedTimer t;
+        t.start();
+        QueryResult &r = results[i];
+        // 先区分无效输入：connected() 对越界和墙壁同样返回 false，不能混入"不连通"的统计
+        if (!view.isOpen(queries[i].start) || (!nearestMode && !view.isOpen(queries[i].end))) {
+            r.invalid = true;
+            r.elapsedNs = t.nsecsElapsed();
+            return;
+        }
+        bool reachable = false;
+        if (nearestMode) {
+            reachable = std::binary_search(goalComponents.begin(), goalComponents.end(),
+                                           components.component(view, queries[i].start));
+        } else {
+            reachable = components.connected(view, queries[i].start, queries[i].end);
+        }
+        if (!reachable) {
+            r.rejected = true;
+            r.elapsedNs = t.nsecsElapsed();
+            return;
+        }
+        ws.expanded = 0;
+        if (nearestMode) {
+            NearestResult nearest;
+            r.found = findNearest(view, {queries[i].start}, goals, options, ws, r.path, &nearest);
+            r.goal = nearest.goal;
+        } else {
+            r.found = findPath(view, queries[i].start, queries[i].end, options, ws, r.path);
+        }
+        r.expanded = ws.expanded;
+        r.elapsedNs = t.nsecsElapsed();
+    };
+
+    timer.restart();
+    std::vector<std::thread> workers;
+    const int workerCount = std::min(threads, n);
+    if (workerCount > 1) {
+        for (int w = 0; w < workerCount; ++w) {
+            workers.emplace_back([&]() {
+                SolverWorkspace ws;
+                for (int i = nextQuery++; i < n; i = nextQuery++) {
+                    solveOne(i, ws);
+                    {
+                        std::lock_guard<std::mutex> lock(readyMutex);
+                        ready[i] = 1;
+                    }
+                    readyChanged.notify_one();
+                }
+            });
+        }
+    }
+
+    SolverWorkspace mainWorkspace;
+    qint64 found = 0, invalid = 0, rejected = 0, expandedTotal = 0, stepsTotal = 0;
+    for (int i = 0; i < n; ++i) {
+        if (workerCount > 1) {
+            std::unique_lock<std::mutex> lock(readyMutex);
+            readyChanged.wait(lock, [&]() { return ready[i] != 0; });
+        } else {
+            solveOne(i, mainWorkspace);
+        }
+
+        QueryResult &r = results[i];
+        QJsonObject line;
+        line["type"] = "result";
+        line["id"] = i;
+        line["start"] = pointJson(queries[i].start);
+        if (!nearestMode) {
+            line["end"] = pointJson(queries[i].end);
+        } else if (r.found) {
+            line["goal"] = r.goal;
+            line["end"] = pointJson(goalPoints[r.goal]);
+        }
+        line["found"] = r.found;
+        if (r.invalid) {
+            line["invalid"] = true;
+            ++invalid;
+        }
+        if (r.rejected) {
+            line["rejected"] = true;
+            ++rejected;
+        }
+        if (r.found) {
+            line["steps"] = r.path.steps();
+            line["cost"] = static_cast<double>(pathCost(r.path)) / kStraightCost; // 直行一步为 1
+            if (printPaths)
+                line["moves"] = r.path.codeString();
+            ++found;
+            stepsTotal += r.path.steps();
+        }
+        line["expanded"] = r.expanded;
+        line["us"] = r.elapsedNs / 1000.0;
+        emitLine(line);
+
+        expandedTotal += r.expanded;
+        r.path.clear(); // 已输出，释放路径
+    }
+    for (std::thread &w : workers)
+        w.join();
+
+    const double totalMs = timer.nsecsElapsed() / 1e6;
+    QJsonObject stats;
+    stats["type"] = "stats";
+    stats["queries"] = n;
+    stats["found"] = found;
+    stats["unreachable"] = n - found - invalid;
+    stats["invalid"] = invalid;
+    stats["rejected"] = rejected;
+    stats["threads"] = workerCount > 1 ? workerCount : 1;
+    stats["neighborhood"] = parser.value(neighborhoodOption);
+    stats["heuristic"] = heuristicName(options.heuristic);
+    stats["expanded"] = expandedTotal;
+    stats["avgSteps"] = found ? static_cast<double>(stepsTotal) / found : 0.0;
+    stats["totalMs"] = totalMs;
+    stats["qps"] = totalMs > 0 ? n / (totalMs / 1000.0) : 0.0;
+    emitLine(stats);
+    return 0;
+}
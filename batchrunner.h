@@ -0,0 +1,22 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QStringList>
+
+// 命令行批处理模式
+// 用法：Mazerobot --batch [选项]
+// 生成或加载一个迷宫，批量求解查询文件中的起终点对，
+// 以 JSON Lines 格式把每个查询的结果和最终统计逐行输出到标准输出。
+// 指定 --goals / --random-goals 时改为最近目标模式：每个查询从起点出发，一次搜索找到最近的目标点。
+// 只依赖 QtCore，不创建任何窗口，也不初始化图形子系统，适合在流水线和无显示器的服务器上运行。
+class BatchRunner
+{
+public:
+    // 命令行中出现该参数时进入批处理模式
+    static const char *const kFlag;
+
+    // 运行批处理，返回进程退出码
+    static int run(const QStringList &arguments);
+};
+
+#endif // BATCHRUNNER_H
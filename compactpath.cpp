@@ -0,0 +1,73 @@
+#include "compactpath.h"
+
+#include <cstdlib> // std::abs
+
+namespace {
+
+// 方向编码表，与 FourConnected / EightConnected 的方向顺序一致：
+// 0-3 为直行（下、右、上、左），4-7 为斜行
+const int kCodeDx[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+const int kCodeDy[8] = {1, 0, -1, 0, 1, -1, 1, -1};
+
+// 以 (dy + 1) * 3 + (dx + 1) 为下标的反查表，-1 表示不是相邻单元格
+const int kCodeFromDelta[9] = {7, 2, 5,
+                               3, -1, 1,
+                               6, 0, 4};
+
+} // namespace
+
+CompactPath::CompactPath(const QPoint &start, int count, int bitsPerStep)
+    : origin(start)
+    , stepCount(count)
+    , bits(bitsPerStep)
+    , valid(true)
+    , words((count + 64 / bitsPerStep - 1) / (64 / bitsPerStep), 0)
+{
+}
+
+int CompactPath::directionCode(int dx, int dy) {
+    if (std::abs(dx) > 1 || std::abs(dy) > 1) return -1;
+    return kCodeFromDelta[(dy + 1) * 3 + (dx + 1)];
+}
+
+QPoint CompactPath::directionDelta(int code) {
+    return QPoint(kCodeDx[code], kCodeDy[code]);
+}
+
+CompactPath CompactPath::fromPoints(const QVector<QPoint> &points) {
+    if (points.isEmpty()) return CompactPath();
+
+    // 只含直行方向时每步 2 位，否则 3 位
+    int bitsPerStep = 2;
+    for (int i = 1; i < points.size(); ++i) {
+        if (points[i].x() != points[i - 1].x() && points[i].y() != points[i - 1].y()) {
+            bitsPerStep = 3;
+            break;
+        }
+    }
+
+    CompactPath path(points.first(), static_cast<int>(points.size()) - 1, bitsPerStep);
+    for (int i = 1; i < points.size(); ++i)
+        path.setStep(i - 1, directionCode(points[i].x() - points[i - 1].x(), points[i].y() - points[i - 1].y()));
+    return path;
+}
+
+QVector<QPoint> CompactPath::toVector() const {
+    QVector<QPoint> points;
+    points.reserve(size());
+    for (const QPoint &p : *this)
+        points.append(p);
+    return points;
+}
+
+QString CompactPath::codeString() const {
+    QString codes;
+    codes.reserve(stepCount);
+    for (int i = 0; i < stepCount; ++i)
+        codes.append(QChar('0' + step(i)));
+    return codes;
+}
+
+int CompactPath::memoryBytes() const {
+    return static_cast<int>(words.size() * sizeof(quint64));
+}
@@ -0,0 +1,81 @@
+#ifndef COMPACTPATH_H
+#define COMPACTPATH_H
+
+#include <QPoint>
+#include <QString>
+#include <QVector>
+
+// 紧凑路径：起点 + 每一步的方向编码
+// 4 邻域路径每步占 2 位，8 邻域路径每步占 3 位（一个 QPoint 占 64 位），
+// 方向编码与 FourConnected / EightConnected 方向表的下标一致。
+// 编码存放在隐式共享的 QVector<quint64> 中，复制只增加引用计数，移动不分配内存。
+class CompactPath
+{
+public:
+    CompactPath() = default;
+
+    // 创建一条从 start 出发、共 stepCount 步的路径，各步方向随后用 setStep() 填写
+    // bitsPerStep: 2 表示只含直行方向，3 表示可以包含斜向
+    CompactPath(const QPoint &start, int stepCount, int bitsPerStep);
+
+    // 从单元格序列构造（相邻两点必须是 8 邻域内的相邻单元格）
+    static CompactPath fromPoints(const QVector<QPoint> &points);
+
+    // 方向编码与坐标增量互相转换
+    static int directionCode(int dx, int dy);
+    static QPoint directionDelta(int code);
+
+    bool isEmpty() const { return !valid; }
+    int size() const { return valid ? stepCount + 1 : 0; } // 单元格数（步数 + 1）
+    int steps() const { return stepCount; }
+    QPoint start() const { return origin; }
+    int bitsPerStep() const { return bits; }
+
+    int step(int i) const {
+        const int perWord = 64 / bits;
+        return static_cast<int>((words[i / perWord] >> ((i % perWord) * bits)) & ((1u << bits) - 1));
+    }
+    void setStep(int i, int code) {
+        const int perWord = 64 / bits;
+        const int shift = (i % perWord) * bits;
+        quint64 &w = words[i / perWord];
+        w = (w & ~(static_cast<quint64>((1u << bits) - 1) << shift)) | (static_cast<quint64>(code) << shift);
+    }
+
+    void clear() { *this = CompactPath(); }
+
+    QVector<QPoint> toVector() const; // 展开为单元格序列（只在确实需要时使用）
+    QString codeString() const;       // 方向编码串，每步一个数字，用于文本输出
+    int memoryBytes() const;          // 编码数据占用的字节数
+
+    // 依次给出路径上各单元格坐标的前向迭代器，边走边解码
+    class const_iterator {
+    public:
+        const_iterator(const CompactPath *p, int i, const QPoint &pos) : path(p), index(i), current(pos) {}
+        QPoint operator*() const { return current; }
+        const_iterator &operator++() {
+            if (index < path->stepCount)
+                current += directionDelta(path->step(index));
+            ++index;
+            return *this;
+        }
+        bool operator!=(const const_iterator &o) const { return index != o.index; }
+        bool operator==(const const_iterator &o) const { return index == o.index; }
+    private:
+        const CompactPath *path;
+        int index;
+        QPoint current;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0, origin); }
+    const_iterator end() const { return const_iterator(this, size(), origin); }
+
+private:
+    QPoint origin;
+    int stepCount = 0;
+    int bits = 2;
+    bool valid = false;
+    QVector<quint64> words;
+};
+
+#endif // COMPACTPATH_H
@@ -0,0 +1,179 @@
+#include "componentlabels.h"
+
+#include "mazegenerator.h"
+
+#include <algorithm> // std::min, std::max
+#include <thread>    // std::thread
+
+namespace {
+
+// 每个行带至少包含的行数，行数太少时分带的线程开销大于收益
+const int kMinBandRows = 64;
+
+} // namespace
+
+int ComponentLabels::root(int cell) const {
+    while (parent[cell] != cell)
+        cell = parent[cell];
+    return cell;
+}
+
+int ComponentLabels::find(int cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+bool ComponentLabels::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    // 编号较大的根挂到较小的根下，结果与合并顺序无关
+    if (a < b) parent[b] = a;
+    else parent[a] = b;
+    return true;
+}
+
+void ComponentLabels::build(const MazeView &view, int threadCount) {
+    parent.resize(view.cellCount());
+    detached.assign(view.cellCount(), 0);
+    components = 0;
+    if (view.rows <= 0 || view.cols <= 0) return;
+
+    if (threadCount <= 0)
+        threadCount = MazeGenerator::defaultThreadCount();
+    const int bandCount = std::max(1, std::min(threadCount, view.rows / kMinBandRows));
+
+    // 在 [row0, row1) 行带内合并，find/unite 只会访问本行带的单元格
+    auto labelBand = [&](int row0, int row1) {
+        for (int y = row0; y < row1; ++y)
+            for (int x = 0; x < view.stride; ++x)
+                parent[view.index(x, y)] = view.index(x, y);
+        for (int y = row0; y < row1; ++y) {
+            for (int x = 0; x < view.cols; ++x) {
+                if (!view.isOpen(x, y)) continue;
+                if (x > 0 && view.isOpen(x - 1, y)) unite(view.index(x, y), view.index(x - 1, y));
+                if (y > row0 && view.isOpen(x, y - 1)) unite(view.index(x, y), view.index(x, y - 1));
+            }
+        }
+    };
+    // 压缩路径：每个单元格直接指向根；只写本行带，只读其他行带
+    std::vector<int> flat(parent.size());
+    auto flattenBand = [&](int row0, int row1) {
+        for (int c = row0 * view.stride; c < row1 * view.stride; ++c)
+            flat[c] = root(c);
+    };
+    auto bandStart = [&](int band) { return band * view.rows / bandCount; };
+
+    if (bandCount <= 1) {
+        labelBand(0, view.rows);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(bandCount);
+        for (int b = 0; b < bandCount; ++b)
+            workers.emplace_back(labelBand, bandStart(b), bandStart(b + 1));
+        for (std::thread &w : workers)
+            w.join();
+
+        // 接缝：每个行带的第一行与上一行带的最后一行
+        for (int b = 1; b < bandCount; ++b) {
+            const int y = bandStart(b);
+            for (int x = 0; x < view.cols; ++x)
+                if (view.isOpen(x, y) && view.isOpen(x, y - 1))
+                    unite(view.index(x, y), view.index(x, y - 1));
+        }
+    }
+
+    if (bandCount <= 1) {
+        flattenBand(0, view.rows);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(bandCount);
+        for (int b = 0; b < bandCount; ++b)
+            workers.emplace_back(flattenBand, bandStart(b), bandStart(b + 1));
+        for (std::thread &w : workers)
+            w.join();
+    }
+    parent.swap(flat);
+
+    for (int y = 0; y < view.rows; ++y)
+        for (int x = 0; x < view.cols; ++x)
+            if (view.isOpen(x, y) && parent[view.index(x, y)] == view.index(x, y))
+                ++components;
+}
+
+void ComponentLabels::cellOpened(const MazeView &view, const QPoint &cell) {
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {1, 0, -1, 0};
+
+    const int c = view.index(cell);
+    if (detached[c]) {
+        // 仍在原区域的集合中：四周有该区域的通路时直接归入原区域，否则集合已不准确，重新标记
+        bool adjacent = false;
+        for (int k = 0; k < 4 && !adjacent; ++k) {
+            const QPoint n = cell + QPoint(dx[k], dy[k]);
+            adjacent = view.isOpen(n) && find(view.index(n)) == find(c);
+        }
+        if (!adjacent) {
+            build(view);
+            return;
+        }
+        detached[c] = 0;
+    } else {
+        ++components; // 新的单元格区域
+    }
+
+    for (int k = 0; k < 4; ++k) {
+        const QPoint n = cell + QPoint(dx[k], dy[k]);
+        if (view.isOpen(n) && unite(c, view.index(n)))
+            --components;
+    }
+}
+
+void ComponentLabels::cellClosed(const MazeView &view, const QPoint &cell) {
+    // 外圈 8 个单元格按顺时针排列，相邻两项在 4 邻域下相邻；偶数下标为直行方向
+    static const int ringDx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int ringDy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    bool ring[8];
+    int orthogonal = 0;
+    for (int k = 0; k < 8; ++k) {
+        ring[k] = view.isOpen(cell.x() + ringDx[k], cell.y() + ringDy[k]);
+        if (k % 2 == 0 && ring[k]) ++orthogonal;
+    }
+
+    if (orthogonal == 0) { // 孤立的单元格，区域随之消失
+        --components;
+        return;
+    }
+
+    // 沿外圈数出包含直行邻居的连续通路段；外圈全是通路时没有段的起点，计为 0
+    int runs = 0;
+    for (int k = 0; k < 8; ++k) {
+        if (!ring[k] || ring[(k + 7) % 8]) continue; // 段的起点：本格通路且前一格不是
+        bool hasOrthogonal = false;
+        for (int j = k; j < k + 8 && ring[j % 8]; ++j)
+            if (j % 2 == 0) hasOrthogonal = true;
+        if (hasOrthogonal) ++runs;
+    }
+
+    if (orthogonal == 1 || runs <= 1) {
+        // 末端单元格，或四周的通路在外圈仍然连通：区域不会被分割
+        detached[view.index(cell)] = 1;
+        return;
+    }
+    build(view); // 可能被分割，重新标记
+}
+
+bool ComponentLabels::connected(const MazeView &view, const QPoint &a, const QPoint &b) const {
+    if (!view.isOpen(a) || !view.isOpen(b)) return false;
+    if (parent.empty()) return true; // 尚未标记，不作判断
+    return root(view.index(a)) == root(view.index(b));
+}
+
+int ComponentLabels::component(const MazeView &view, const QPoint &p) const {
+    if (!view.isOpen(p) || parent.empty()) return -1;
+    return root(view.index(p));
+}
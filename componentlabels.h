@@ -0,0 +1,54 @@
+#ifndef COMPONENTLABELS_H
+#define COMPONENTLABELS_H
+
+#include "mazegrid.h"
+
+#include <QPoint>
+
+#include <vector> // std::vector
+
+// 连通区域标记（并查集）
+// 迷宫生成或加载后用 build() 一次性标记所有通路单元格所属的连通区域：
+// 按行分带，各线程在自己的行带内独立合并（互不写入同一单元格，无需加锁），
+// 再顺序合并相邻行带的接缝，最后并行压缩路径，使每个单元格直接指向所在区域的根。
+// 此后 connected() 在 O(1) 时间内判断两点是否可能互相到达，寻路前据此直接拒绝不可达的查询。
+//
+// 由于 8 邻域的墙角规则要求斜向移动两侧的直行单元格都是通路，
+// 8 邻域下的连通区域与 4 邻域完全相同，因此只按 4 邻域标记一次即可。
+//
+// 编辑单个单元格时增量更新：打通墙壁只需与四周通路合并；
+// 砌墙时，如果四周的通路单元格在外圈 8 个单元格内仍然互相连通，则区域不可能被分割，
+// 该单元格作为墙壁留在原区域的集合中（connected() 会先检查两端是否为通路），否则重新标记整个迷宫。
+// 并查集中每个集合内的通路单元格始终恰好构成一个连通区域。
+class ComponentLabels
+{
+public:
+    // 标记整个迷宫；threadCount <= 0 时使用全部硬件线程
+    void build(const MazeView &view, int threadCount = 0);
+
+    // 单元格 cell 已由墙壁改为通路 / 由通路改为墙壁（view 为修改后的迷宫）
+    void cellOpened(const MazeView &view, const QPoint &cell);
+    void cellClosed(const MazeView &view, const QPoint &cell);
+
+    // a、b 都是通路且位于同一连通区域
+    // 不修改任何数据，build() 之后可以在多个线程中同时调用
+    bool connected(const MazeView &view, const QPoint &a, const QPoint &b) const;
+
+    // p 所在连通区域的编号（区域根单元格的编号）；p 不是通路或尚未标记时返回 -1
+    // 两个通路单元格的编号相同当且仅当 connected() 为真，同样可以在多个线程中同时调用
+    int component(const MazeView &view, const QPoint &p) const;
+
+    int componentCount() const { return components; } // 通路连通区域的个数
+    bool isEmpty() const { return parent.empty(); }
+
+private:
+    std::vector<int> parent;    // 并查集，下标为单元格编号；墙壁单元格也占一项
+    std::vector<char> detached; // 砌墙后仍留在原区域集合中的单元格
+    int components = 0;
+
+    int root(int cell) const;   // 只读查找
+    int find(int cell);         // 查找并折半压缩路径
+    bool unite(int a, int b);   // 合并，返回是否原本属于不同区域
+};
+
+#endif // COMPONENTLABELS_H
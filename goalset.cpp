@@ -0,0 +1,41 @@
+#include "goalset.h"
+
+#include <cmath> // std::sqrt
+
+GoalSet::GoalSet(const MazeView &view, const QVector<QPoint> &goalPoints, int size)
+    : goals(goalPoints)
+{
+    std::vector<int> valid;
+    for (int i = 0; i < goals.size(); ++i)
+        if (view.isOpen(goals[i]))
+            valid.push_back(i);
+
+    if (size <= 0) {
+        const double area = static_cast<double>(view.rows) * view.cols;
+        size = static_cast<int>(std::sqrt(2.0 * area / std::max<size_t>(1, valid.size())));
+    }
+    bucketSize = std::max(4, size);
+    bucketCols = (view.cols + bucketSize - 1) / bucketSize;
+    bucketRows = (view.rows + bucketSize - 1) / bucketSize;
+
+    // 计数排序：先数出每个桶的目标数，再按桶写入
+    bucketStart.assign(bucketCols * bucketRows + 1, 0);
+    for (int i : valid)
+        ++bucketStart[bucketOf(goals[i].x(), goals[i].y()) + 1];
+    for (size_t b = 1; b < bucketStart.size(); ++b)
+        bucketStart[b] += bucketStart[b - 1];
+    order.resize(valid.size());
+    std::vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (int i : valid)
+        order[fill[bucketOf(goals[i].x(), goals[i].y())]++] = i;
+}
+
+int GoalSet::goalAt(int x, int y) const {
+    if (order.empty() || x < 0 || y < 0 || x >= bucketCols * bucketSize || y >= bucketRows * bucketSize)
+        return -1;
+    const int b = bucketOf(x, y);
+    for (int k = bucketStart[b]; k < bucketStart[b + 1]; ++k)
+        if (goals[order[k]] == QPoint(x, y))
+            return order[k];
+    return -1;
+}
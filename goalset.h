@@ -0,0 +1,83 @@
+#ifndef GOALSET_H
+#define GOALSET_H
+
+#include "mazegrid.h"
+
+#include <QPoint>
+#include <QVector>
+
+#include <algorithm>   // std::min, std::max
+#include <climits>     // INT_MAX
+#include <cstdlib>     // std::abs
+#include <type_traits> // std::is_same
+#include <vector>      // std::vector
+
+struct ZeroHeuristic;
+
+// 多目标查询的目标集合及其空间索引
+// 把迷宫划分为 bucketSize x bucketSize 的桶，目标按所在的桶连续存放（CSR 格式）。
+// 求某点到最近目标的启发值时，从该点所在的桶开始一圈一圈向外查找，
+// 一旦外圈桶中目标的距离下界不小于已找到的最小值就停止，因此目标很多时也只需检查附近的少数几个。
+// 墙壁上和迷宫范围外的目标被忽略。
+class GoalSet
+{
+public:
+    GoalSet() = default;
+    // bucketSize <= 0 时按目标数量自动选择，使每个桶平均约有 2 个目标
+    GoalSet(const MazeView &view, const QVector<QPoint> &goals, int bucketSize = 0);
+
+    const QVector<QPoint> &points() const { return goals; } // 构造时给出的全部目标（包括被忽略的）
+    int validCount() const { return static_cast<int>(order.size()); }
+    bool isEmpty() const { return order.empty(); }
+
+    // (x, y) 处目标在 points() 中的下标，不是目标时返回 -1
+    int goalAt(int x, int y) const;
+
+    // 从 (x, y) 到最近目标的启发值：对所有目标取 H::estimate 的最小值
+    // 单个目标的启发函数是一致的，取最小值后仍是一致的
+    template <class H>
+    int estimate(int x, int y) const;
+
+private:
+    QVector<QPoint> goals;
+    int bucketSize = 1;
+    int bucketCols = 0;
+    int bucketRows = 0;
+    std::vector<int> bucketStart; // 第 b 个桶的目标为 order[bucketStart[b] .. bucketStart[b + 1])
+    std::vector<int> order;       // 按桶排列的目标下标
+
+    int bucketOf(int x, int y) const { return (y / bucketSize) * bucketCols + x / bucketSize; }
+};
+
+template <class H>
+int GoalSet::estimate(int x, int y) const {
+    if (std::is_same<H, ZeroHeuristic>::value || order.empty())
+        return 0;
+
+    const int bx = x / bucketSize;
+    const int by = y / bucketSize;
+    const int maxRing = std::max(bucketCols, bucketRows);
+    int best = INT_MAX;
+    for (int r = 0; r <= maxRing; ++r) {
+        // 第 r 圈的桶中任一目标与 (x, y) 在某个方向上至少相距 d = (r-1)*bucketSize+1 格，
+        // 而各启发函数对两个方向的距离都是单调的，因此 H::estimate(d, 0) 是这一圈的下界
+        if (r > 0 && best <= H::estimate((r - 1) * bucketSize + 1, 0))
+            break;
+        for (int j = by - r; j <= by + r; ++j) {
+            if (j < 0 || j >= bucketRows) continue;
+            const bool edgeRow = j == by - r || j == by + r;
+            const int step = edgeRow ? 1 : 2 * r; // 中间各行只取左右两端的桶
+            for (int i = bx - r; i <= bx + r; i += step) {
+                if (i < 0 || i >= bucketCols) continue;
+                const int b = j * bucketCols + i;
+                for (int k = bucketStart[b]; k < bucketStart[b + 1]; ++k) {
+                    const QPoint &g = goals[order[k]];
+                    best = std::min(best, H::estimate(std::abs(x - g.x()), std::abs(y - g.y())));
+                }
+            }
+        }
+    }
+    return best;
+}
+
+#endif // GOALSET_H
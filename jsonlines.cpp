@@ -0,0 +1,73 @@
+#include "jsonlines.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm> // std::find
+#include <cstdio>    // std::fwrite, std::fflush, stdout, stdin
+
+void emitLine(const QJsonObject &object) {
+    QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+    std::fflush(stdout);
+}
+
+int failWith(const QString &message) {
+    QJsonObject error;
+    error["type"] = "error";
+    error["message"] = message;
+    emitLine(error);
+    return 1;
+}
+
+QJsonArray pointJson(const QPoint &p) {
+    return QJsonArray{p.x(), p.y()};
+}
+
+bool readNumberLines(const QString &fileName, const QString &what, std::initializer_list<int> counts,
+                     const std::function<void(const QVector<int> &)> &handle, QString &error) {
+    QFile file(fileName);
+    bool opened = false;
+    if (fileName == "-")
+        opened = file.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    else
+        opened = file.open(QIODevice::ReadOnly | QIODevice::Text);
+    if (!opened) {
+        error = QString("无法打开%1 %2。").arg(what, fileName);
+        return false;
+    }
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().simplified(); // 合并连续空白
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        const QStringList parts = line.split(' ');
+        QVector<int> numbers;
+        bool ok = std::find(counts.begin(), counts.end(), static_cast<int>(parts.size())) != counts.end();
+        for (int i = 0; ok && i < parts.size(); ++i)
+            numbers.append(parts[i].toInt(&ok));
+        if (!ok) {
+            error = QString("%1第 %2 行格式不正确。").arg(what).arg(lineNumber);
+            return false;
+        }
+        handle(numbers);
+    }
+    return true;
+}
+
+bool readQueries(const QString &fileName, QVector<Query> &queries, QString &error, bool startOnly) {
+    auto append = [&](const QVector<int> &v) {
+        Query q;
+        q.start = QPoint(v[0], v[1]);
+        q.end = v.size() == 4 ? QPoint(v[2], v[3]) : q.start;
+        queries.append(q);
+    };
+    if (startOnly)
+        return readNumberLines(fileName, "查询文件", {2, 4}, append, error);
+    return readNumberLines(fileName, "查询文件", {4}, append, error);
+}
@@ -0,0 +1,38 @@
+#ifndef JSONLINES_H
+#define JSONLINES_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPoint>
+#include <QString>
+#include <QVector>
+
+#include <functional>       // std::function
+#include <initializer_list> // std::initializer_list
+
+// 命令行模式（--batch、--tiled、--serve、--loadgen）共用的 JSON Lines 输出和坐标文件读取
+
+// 输出一行紧凑 JSON 并立即刷新：标准输出接到管道时是全缓冲的，不刷新的话下游要等到缓冲区写满或进程结束才能读到结果
+void emitLine(const QJsonObject &object);
+
+// 输出一行 {"type":"error","message":...}，返回进程退出码 1
+int failWith(const QString &message);
+
+// 坐标输出为 [x, y]
+QJsonArray pointJson(const QPoint &p);
+
+// 一个起终点查询
+struct Query {
+    QPoint start;
+    QPoint end;
+};
+
+// 逐行读取整数坐标文件：空行和以 # 开头的行忽略；文件名为 "-" 时读取标准输入
+// 每行的数字个数必须是 counts 之一，读到的数字交给 handle；what 是出错信息中的文件说明
+bool readNumberLines(const QString &fileName, const QString &what, std::initializer_list<int> counts,
+                     const std::function<void(const QVector<int> &)> &handle, QString &error);
+
+// 读取查询文件：每行 "sx sy ex ey"；startOnly 为 true 时也可以只写起点 "sx sy"（终点记为起点）
+bool readQueries(const QString &fileName, QVector<Query> &queries, QString &error, bool startOnly = false);
+
+#endif // JSONLINES_H
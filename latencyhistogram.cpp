@@ -0,0 +1,54 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms> // qCountLeadingZeroBits
+
+#include <cmath> // std::ceil
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (std::atomic<quint64> &b : buckets)
+        b.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketOf(quint64 value) {
+    if (value < kSubBuckets) return static_cast<int>(value);
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+    const int sub = static_cast<int>((value >> (msb - 4)) & (kSubBuckets - 1));
+    return (msb - 3) * kSubBuckets + sub;
+}
+
+quint64 LatencyHistogram::bucketValue(int bucket) {
+    if (bucket < kSubBuckets) return static_cast<quint64>(bucket);
+    const int msb = bucket / kSubBuckets + 3;
+    const quint64 sub = static_cast<quint64>(bucket % kSubBuckets);
+    return (kSubBuckets + sub) << (msb - 4);
+}
+
+void LatencyHistogram::record(qint64 nanoseconds) {
+    const quint64 value = nanoseconds > 0 ? static_cast<quint64>(nanoseconds) : 0;
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    // percentile(100) 只能给出所在桶的下界，最大值单独用比较交换维护
+    quint64 seen = largest.load(std::memory_order_relaxed);
+    while (value > seen && !largest.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 LatencyHistogram::percentile(double p) const {
+    const quint64 n = count();
+    if (n == 0) return 0;
+    quint64 rank = static_cast<quint64>(std::ceil(n * p / 100.0));
+    if (rank < 1) rank = 1;
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return static_cast<qint64>(bucketValue(i));
+    }
+    return static_cast<qint64>(bucketValue(kBucketCount - 1));
+}
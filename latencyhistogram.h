@@ -0,0 +1,39 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+#include <array>  // std::array
+#include <atomic> // std::atomic
+
+// 延迟直方图（对数-线性分桶）
+// 每个 2 的幂区间再均分为 16 个桶，相对误差不超过 1/16；
+// 记录只是一次原子加法，多个工作线程可以同时调用 record()，不需要加锁，也不保存样本。
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 nanoseconds);
+
+    // 第 p 百分位（0 < p <= 100）的延迟，单位纳秒；没有样本时返回 0
+    qint64 percentile(double p) const;
+    quint64 count() const { return total.load(std::memory_order_relaxed); }
+    // 记录过的最大延迟（精确值，不受分桶误差影响），单位纳秒
+    qint64 max() const { return static_cast<qint64>(largest.load(std::memory_order_relaxed)); }
+
+    void reset();
+
+private:
+    static const int kSubBuckets = 16;
+    static const int kBucketCount = 64 * kSubBuckets;
+
+    static int bucketOf(quint64 value);
+    static quint64 bucketValue(int bucket); // 桶内的最小值
+
+    std::array<std::atomic<quint64>, kBucketCount> buckets;
+    std::atomic<quint64> total;
+    std::atomic<quint64> largest;
+};
+
+#endif // LATENCYHISTOGRAM_H
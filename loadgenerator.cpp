@@ -0,0 +1,225 @@
+#include "loadgenerator.h"
+
+#include "jsonlines.h"
+#include "latencyhistogram.h"
+#include "pathsolver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+
+#include <deque>      // std::deque
+#include <functional> // std::function
+#include <vector>     // std::vector
+
+const char *const LoadGenerator::kFlag = "--loadgen";
+
+namespace {
+
+// 连接服务：port > 0 时连接 127.0.0.1 的 TCP 端口，否则连接本地套接字
+// 连接断开时调用 onDisconnected
+QIODevice *openConnection(const QString &socketName, quint16 port, QObject *parent,
+                          const std::function<void()> &onDisconnected, QString &error) {
+    if (port > 0) {
+        QTcpSocket *socket = new QTcpSocket(parent);
+        socket->connectToHost(QHostAddress::LocalHost, port);
+        if (!socket->waitForConnected(3000)) {
+            error = socket->errorString();
+            return nullptr;
+        }
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        QObject::connect(socket, &QTcpSocket::disconnected, parent, onDisconnected);
+        return socket;
+    }
+    QLocalSocket *socket = new QLocalSocket(parent);
+    socket->connectToServer(socketName);
+    if (!socket->waitForConnected(3000)) {
+        error = socket->errorString();
+        return nullptr;
+    }
+    QObject::connect(socket, &QLocalSocket::disconnected, parent, onDisconnected);
+    return socket;
+}
+
+// 查询端点从服务端随机取样的通路单元格数
+const int kSampleCells = 4096;
+
+// 从 "MAZES a:RxC b:RxC ..." 中找出指定迷宫的尺寸
+bool findMazeSize(const QByteArray &reply, const QByteArray &name, int &rows, int &cols) {
+    const QList<QByteArray> parts = reply.simplified().split(' ');
+    for (int i = 1; i < parts.size(); ++i) {
+        const int colon = parts[i].lastIndexOf(':');
+        if (colon < 0 || parts[i].left(colon) != name) continue;
+        const QList<QByteArray> size = parts[i].mid(colon + 1).split('x');
+        if (size.size() != 2) return false;
+        rows = size[0].toInt();
+        cols = size[1].toInt();
+        return rows > 0 && cols > 0;
+    }
+    return false;
+}
+
+// 一条压测连接
+struct Client {
+    QIODevice *socket = nullptr;
+    std::deque<qint64> sentAt; // 在途请求的发出时刻（纳秒），回复按顺序返回，与之一一对应
+};
+
+} // namespace
+
+int LoadGenerator::run(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("寻路服务压测客户端：结果以一行 JSON 输出到标准输出。");
+    parser.addHelpOption();
+
+    QCommandLineOption loadgenOption("loadgen", "进入压测模式（必须）。");
+    QCommandLineOption socketOption("socket", "服务的本地套接字名称。", "name", "mazerobot");
+    QCommandLineOption portOption("port", "改为连接 127.0.0.1 上的 TCP 端口。", "port");
+    QCommandLineOption mazeOption("maze", "查询的迷宫名称。", "name", "default");
+    QCommandLineOption clientsOption("clients", "并发连接数。", "n", "4");
+    QCommandLineOption depthOption("depth", "每条连接的流水线深度（在途请求数）。", "n", "16");
+    QCommandLineOption requestsOption("requests", "请求总数。", "n", "10000");
+    QCommandLineOption seedOption("seed", "随机查询的种子。", "n", "1");
+    QCommandLineOption neighborhoodOption("neighborhood", "邻域：4 或 8。", "4|8", "4");
+    QCommandLineOption heuristicOption("heuristic", "启发函数：manhattan、octile 或 zero；8 邻域下 manhattan 改用 octile。", "name", "manhattan");
+    parser.addOptions({loadgenOption, socketOption, portOption, mazeOption, clientsOption, depthOption,
+                       requestsOption, seedOption, neighborhoodOption, heuristicOption});
+    parser.process(arguments);
+
+    const QString socketName = parser.value(socketOption);
+    const quint16 port = static_cast<quint16>(parser.value(portOption).toUInt());
+    const QByteArray mazeName = parser.value(mazeOption).toUtf8();
+    const int clientCount = qMax(1, parser.value(clientsOption).toInt());
+    const int depth = qMax(1, parser.value(depthOption).toInt());
+    const qint64 total = qMax(1, parser.value(requestsOption).toInt());
+
+    // 每个请求都带上邻域和启发函数，先按服务端相同的规则检查一遍
+    SolverOptions options;
+    if (!parseNeighborhood(parser.value(neighborhoodOption), options.neighborhood))
+        return failWith("--neighborhood 只能是 4 或 8。");
+    if (!parseHeuristic(parser.value(heuristicOption), options.heuristic))
+        return failWith("--heuristic 只能是 manhattan、octile 或 zero。");
+    options = admissibleOptions(options);
+    const QByteArray suffix = ' ' + parser.value(neighborhoodOption).toLatin1()
+            + ' ' + heuristicName(options.heuristic).toLatin1();
+
+    // ---------- 建立连接 ----------
+    bool finished = false;
+    int exitCode = 0;
+    QObject context; // 所有套接字和信号连接的父对象
+    auto onDisconnected = [&]() {
+        if (finished) return;
+        finished = true;
+        exitCode = failWith("服务端断开了连接。");
+        QCoreApplication::exit(exitCode);
+    };
+
+    std::vector<Client> clients(clientCount);
+    for (Client &client : clients) {
+        QString error;
+        client.socket = openConnection(socketName, port, &context, onDisconnected, error);
+        if (!client.socket)
+            return failWith(QString("无法连接服务：%1").arg(error));
+    }
+
+    // 先确认迷宫存在，再向服务端取一批随机通路单元格作为查询端点；
+    // 加载的迷宫不一定是生成的完美迷宫，不能假定奇数坐标都是通路
+    QIODevice *first = clients.front().socket;
+    auto request = [&](const QByteArray &line, QByteArray &reply) {
+        first->write(line);
+        while (!first->canReadLine())
+            if (!first->waitForReadyRead(3000))
+                return false;
+        reply = first->readLine();
+        return true;
+    };
+    QByteArray reply;
+    if (!request("MAZES\n", reply))
+        return failWith("等待 MAZES 回复超时。");
+    int rows = 0, cols = 0;
+    if (!findMazeSize(reply, mazeName, rows, cols))
+        return failWith(QString("服务端没有名为 %1 的迷宫。").arg(QString::fromUtf8(mazeName)));
+    if (!request("SAMPLE " + mazeName + ' ' + QByteArray::number(kSampleCells) + ' '
+                 + parser.value(seedOption).toLatin1() + '\n', reply))
+        return failWith("等待 SAMPLE 回复超时。");
+    const QList<QByteArray> sample = reply.simplified().split(' ');
+    if (sample.size() < 3 || sample[0] != "CELLS")
+        return failWith(QString("迷宫 %1 中找不到通路单元格。").arg(QString::fromUtf8(mazeName)));
+    QVector<QByteArray> cells; // 每个元素为 "x y"
+    for (int i = 1; i + 1 < sample.size(); i += 2)
+        cells.append(sample[i] + ' ' + sample[i + 1]);
+
+    // ---------- 压测 ----------
+    QRandomGenerator rng(parser.value(seedOption).toUInt());
+    auto randomCell = [&]() {
+        return cells[static_cast<int>(rng.bounded(static_cast<quint32>(cells.size())))];
+    };
+
+    LatencyHistogram latency;
+    QElapsedTimer clock;
+    qint64 sent = 0, done = 0, ok = 0, none = 0, errors = 0;
+
+    // 把该连接的在途请求补足到流水线深度，一次写出
+    auto pump = [&](Client &client) {
+        QByteArray out;
+        while (static_cast<int>(client.sentAt.size()) < depth && sent < total) {
+            out += "SOLVE " + mazeName + ' ' + randomCell() + ' ' + randomCell() + suffix + '\n';
+            client.sentAt.push_back(clock.nsecsElapsed());
+            ++sent;
+        }
+        if (!out.isEmpty())
+            client.socket->write(out);
+    };
+
+    auto report = [&]() {
+        const qint64 elapsed = clock.nsecsElapsed();
+        QJsonObject stats;
+        stats["type"] = "loadgen";
+        stats["requests"] = done;
+        stats["clients"] = clientCount;
+        stats["depth"] = depth;
+        stats["found"] = ok;
+        stats["unreachable"] = none;
+        stats["errors"] = errors;
+        stats["totalMs"] = elapsed / 1e6;
+        stats["qps"] = elapsed > 0 ? done / (elapsed / 1e9) : 0.0;
+        stats["p50us"] = latency.percentile(50) / 1000.0;
+        stats["p99us"] = latency.percentile(99) / 1000.0;
+        stats["maxUs"] = latency.max() / 1000.0;
+        emitLine(stats);
+    };
+
+    for (Client &client : clients) {
+        Client *c = &client;
+        QObject::connect(c->socket, &QIODevice::readyRead, &context, [&, c]() {
+            while (c->socket->canReadLine()) {
+                const QByteArray reply = c->socket->readLine();
+                if (c->sentAt.empty()) continue; // 不应出现：没有在途请求却收到回复
+                latency.record(clock.nsecsElapsed() - c->sentAt.front());
+                c->sentAt.pop_front();
+                ++done;
+                if (reply.startsWith("OK")) ++ok;
+                else if (reply.startsWith("NONE")) ++none;
+                else ++errors;
+            }
+            if (done == total && !finished) {
+                finished = true;
+                report();
+                QCoreApplication::exit(0);
+                return;
+            }
+            pump(*c);
+        });
+    }
+
+    clock.start();
+    for (Client &client : clients)
+        pump(client);
+    QCoreApplication::exec();
+    return exitCode;
+}
@@ -0,0 +1,19 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QStringList>
+
+// 寻路服务的压测客户端
+// 用法：Mazerobot --loadgen [--socket 名称 | --port 端口] [--maze 名称] [--clients n] [--depth n] [--requests n]
+// 建立若干条连接，每条连接保持固定数量的在途请求（流水线深度），向 SolverService 发送随机 SOLVE 请求，
+// 在客户端测量每个请求从发出到收到回复的延迟，结束后以一行 JSON 输出 QPS 和 p50/p99 延迟。
+class LoadGenerator
+{
+public:
+    // 命令行中出现该参数时进入压测模式
+    static const char *const kFlag;
+
+    static int run(const QStringList &arguments);
+};
+
+#endif // LOADGENERATOR_H
@@ -1,8 +1,39 @@
 #include "mainwindow.h"
+#include "batchrunner.h"
+#include "loadgenerator.h"
+#include "solverservice.h"
+#include "tiledrunner.h"
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // 命令行模式：只创建 QCoreApplication，
+    // 不构造 QApplication 和 MainWindow，因此不会初始化任何窗口或图形子系统
+    //   --batch    批处理（BatchRunner）
+    //   --serve    常驻寻路服务（SolverService）
+    //   --loadgen  寻路服务的压测客户端（LoadGenerator）
+    //   --tiled    磁盘分块地图的转换与求解（TiledRunner）
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], BatchRunner::kFlag) == 0) {
+            QCoreApplication app(argc, argv);
+            return BatchRunner::run(app.arguments());
+        }
+        if (std::strcmp(argv[i], SolverService::kFlag) == 0) {
+            QCoreApplication app(argc, argv);
+            return SolverService::run(app.arguments());
+        }
+        if (std::strcmp(argv[i], LoadGenerator::kFlag) == 0) {
+            QCoreApplication app(argc, argv);
+            return LoadGenerator::run(app.arguments());
+        }
+        if (std::strcmp(argv[i], TiledRunner::kFlag) == 0) {
+            QCoreApplication app(argc, argv);
+            return TiledRunner::run(app.arguments());
+        }
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
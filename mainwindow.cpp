@@ -1,13 +1,15 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h" // 包含UI头文件，用于访问UI元素
+#include "mazegenerator.h" // 分块并行迷宫生成器
+#include "mazeio.h"        // 迷宫文件读写
+
+#include <QElapsedTimer> // 生成耗时统计
 
 // 标准库头文件 (已在 mainwindow.h 中引入，但为了清晰性可再次引入)
-#include <queue>       // std::priority_queue
 #include <vector>      // std::vector
 #include <algorithm>   // std::sort, std::abs
 #include <cmath>       // std::abs (用于 int/double 等)
 #include <cstdlib>     // abs
-#include <map>         // std::map
 
 // MainWindow 类的构造函数
 MainWindow::MainWindow(QWidget *parent)
@@ -55,6 +57,15 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnShortest, &QPushButton::clicked, this, &MainWindow::on_btnShortest_clicked);
     connect(ui->btnLoad, &QPushButton::clicked, this, &MainWindow::on_btnLoad_clicked);
     connect(ui->btnNextPath, &QPushButton::clicked, this, &MainWindow::on_btnNextPath_clicked);
+    connect(ui->btnMultiAgent, &QPushButton::clicked, this, &MainWindow::onMultiAgentClicked);
+    connect(ui->btnNearestGoal, &QPushButton::clicked, this, &MainWindow::onNearestGoalClicked);
+    connect(ui->btnEditWall, &QPushButton::toggled, this, &MainWindow::onEditWallToggled);
+    connect(ui->btnEditGoals, &QPushButton::toggled, this, &MainWindow::onEditGoalsToggled);
+    // 8 邻域下曼哈顿距离不可采纳（见 admissibleOptions），切换到 8 邻域时把启发函数改为八方向距离
+    connect(ui->cmbNeighborhood, &QComboBox::currentIndexChanged, this, [this](int index) {
+        if (index == 1 && ui->cmbHeuristic->currentIndex() == 0)
+            ui->cmbHeuristic->setCurrentIndex(1);
+    });
 
     // 初始化动画计时器
     animationTimer = new QTimer(this);
@@ -70,7 +81,6 @@ MainWindow::~MainWindow()
 {
     delete ui; // 释放UI界面内存
     // Note: scene管理的QGraphicsItem会在scene析构时自动释放
-    // Node对象在aStar函数中已经清理，所以这里通常不需要额外清理
 }
 
 // 生成迷宫函数（使用Prim算法）
@@ -86,78 +96,13 @@ void MainWindow::generateMaze(int r, int c) {
     rows = r;
     cols = c;
 
-    // 初始化所有单元格为墙壁 (1)
-    for (int i = 0; i < rows; ++i)
-        for (int j = 0; j < cols; ++j)
-            maze[i][j] = 1;
-
-    // Prim 算法生成迷宫
-    QVector<QPoint> frontier; // 边界点（待处理的墙壁）列表
-
-    // 辅助lambda函数：将指定点添加到frontier列表
-    auto addFrontier = [&](int y, int x) {
-        // 检查边界并确保是墙壁 (1)
-        if (x >= 0 && x < cols && y >= 0 && y < rows && maze[y][x] == 1) {
-            frontier.append(QPoint(x, y));
-            maze[y][x] = 2; // 标记为“待处理前沿”，避免重复添加
-        }
-    };
+    // 分块并行 Prim 算法生成迷宫（见 mazegenerator.h）
+    // 每次生成取一个新种子；相同的种子和线程数总会生成相同的迷宫
+    mazeSeed = QRandomGenerator::global()->generate();
+    MazeGenerator::generate(&maze[0][0], rows, cols, MAX_COLS, mazeSeed, generatorThreads);
 
-    // 随机选择一个起始点（必须是奇数坐标，以便Prim算法在墙壁网格上工作）
-    // 确保起点在迷宫范围内，并尝试找到一个可行的奇数坐标作为起点
+    // 起点固定为左上角第一个逻辑单元格 (1,1)，行列数不小于3时它总是通路
     startPoint = QPoint(1, 1);
-    if (startPoint.y() >= rows || startPoint.x() >= cols || startPoint.y() % 2 == 0 || startPoint.x() % 2 == 0) {
-        // 如果默认起点不合法，尝试在迷宫内找到一个合法的奇数坐标
-        startPoint = QPoint((cols - 1) / 2 * 2 + 1, (rows - 1) / 2 * 2 + 1); // 居中奇数点
-        if (startPoint.x() >= cols) startPoint.setX(cols - (cols % 2 == 0 ? 3 : 2));
-        if (startPoint.y() >= rows) startPoint.setY(rows - (rows % 2 == 0 ? 3 : 2));
-        if (startPoint.x() < 1) startPoint.setX(1);
-        if (startPoint.y() < 1) startPoint.setY(1);
-    }
-    maze[startPoint.y()][startPoint.x()] = 0; // 将起始点设为通路
-
-    // 添加起始点周围的初始前沿单元格 (距离为2的墙体)
-    addFrontier(startPoint.y(), startPoint.x() + 2);
-    addFrontier(startPoint.y(), startPoint.x() - 2);
-    addFrontier(startPoint.y() + 2, startPoint.x());
-    addFrontier(startPoint.y() - 2, startPoint.x());
-
-    // 主循环：当边界点列表不为空时
-    while (!frontier.isEmpty()) {
-        // 随机选择一个边界点
-        int idx = QRandomGenerator::global()->bounded(frontier.size());
-        QPoint f = frontier[idx];
-        frontier.removeAt(idx); // 从列表中移除
-
-        int x = f.x();
-        int y = f.y();
-
-        // 查找与当前前沿单元格相邻的已挖空路径单元格 (距离为2的通路)
-        QVector<QPoint> neighbors;
-        for (QPoint d : {QPoint(0, 2), QPoint(0, -2), QPoint(2, 0), QPoint(-2, 0)}) { // 上下左右四个方向
-            int nx = x + d.x();
-            int ny = y + d.y();
-            if (nx >= 0 && nx < cols && ny >= 0 && ny < rows && maze[ny][nx] == 0) {
-                neighbors.append(QPoint(nx, ny));
-            }
-        }
-
-        if (!neighbors.isEmpty()) {
-            // 随机选择一个已挖空路径邻居
-            QPoint n = neighbors[QRandomGenerator::global()->bounded(neighbors.size())];
-            int wallX = (x + n.x()) / 2; // 计算前沿单元格和已挖空邻居之间的墙壁
-            int wallY = (y + n.y()) / 2;
-
-            maze[y][x] = 0; // 挖空当前前沿单元格
-            maze[wallY][wallX] = 0; // 挖空当前和邻居之间的墙壁
-
-            // 将新挖空路径周围的新前沿单元格添加到frontier列表
-            addFrontier(y, x + 2);
-            addFrontier(y, x - 2);
-            addFrontier(y + 2, x);
-            addFrontier(y - 2, x);
-        }
-    }
 
     // 设置终点
     endPoint = QPoint(cols - 2, rows - 2); // 默认设置为右下角倒数第二个奇数点
@@ -195,10 +140,14 @@ void MainWindow::generateMaze(int r, int c) {
 
     // 清空之前的路径和动画状态
     blockedPoints.clear();
-    currentPath.clear();
+    goalPoints.clear(); // 目标点可能落在新迷宫的墙壁上
+    animatedPath.clear();
     allPaths.clear();
+    agentPaths.clear();
     pathIndex = -1;
     animationIndex = 0;
+
+    onMazeChanged();
 }
 
 // 绘制迷宫函数
@@ -240,24 +189,70 @@ void MainWindow::drawMaze() {
                      endPoint.y() * cellSize + cellSize / 2);
     scene->addEllipse(endCenter.x() - 5, endCenter.y() - 5, 10, 10,
                       QPen(Qt::blue), QBrush(Qt::blue));
+
+    // 绘制候选目标点：橙色方块
+    QColor goalColor(255, 140, 0);
+    for (const QPoint &g : goalPoints)
+        scene->addRect(g.x() * cellSize + 4, g.y() * cellSize + 4, cellSize - 8, cellSize - 8,
+                       QPen(goalColor), QBrush(goalColor));
 }
 
 // 绘制路径函数
-void MainWindow::drawPath(const QStack<QPoint> &path) {
+void MainWindow::drawPath(const CompactPath &path, int count) {
     drawMaze(); // 首先绘制迷宫墙体和起终点
 
     // 路径：高亮绿色，半透明，更粗的线条
     QPen pathPen(QColor(0, 255, 0, 180)); // 绿色，alpha 180 (稍微半透明)
     pathPen.setWidth(5); // 设置线宽为5像素
 
-    // 遍历路径点，绘制连接线
-    for (int i = 1; i < path.size(); ++i) {
+    if (count < 0 || count > path.size())
+        count = path.size();
+
+    // 沿紧凑路径边解码边绘制连接线，不展开成坐标数组
+    CompactPath::const_iterator it = path.begin();
+    QPoint prev = *it;
+    for (int i = 1; i < count; ++i) {
+        ++it;
+        QPoint cur = *it;
         // 计算当前点和上一个点的中心坐标
-        QPointF p1(path[i - 1].x() * cellSize + cellSize / 2.0,
-                   path[i - 1].y() * cellSize + cellSize / 2.0);
-        QPointF p2(path[i].x() * cellSize + cellSize / 2.0,
-                   path[i].y() * cellSize + cellSize / 2.0);
+        QPointF p1(prev.x() * cellSize + cellSize / 2.0,
+                   prev.y() * cellSize + cellSize / 2.0);
+        QPointF p2(cur.x() * cellSize + cellSize / 2.0,
+                   cur.y() * cellSize + cellSize / 2.0);
         scene->addLine(QLineF(p1, p2), pathPen); // 绘制线段
+        prev = cur;
+    }
+}
+
+// 绘制多机器人：轨迹、当前位置和目标
+void MainWindow::drawAgents(int step) {
+    drawMaze();
+
+    for (int i = 0; i < agentPaths.size(); ++i) {
+        const QVector<QPoint> &path = agentPaths[i];
+        if (path.isEmpty()) continue; // 规划失败的机器人不显示
+
+        QColor color = QColor::fromHsv(i * 360 / agentPaths.size(), 200, 230); // 每个机器人一种颜色
+        int last = std::min(step, static_cast<int>(path.size()) - 1);
+
+        // 目标：同色空心方框
+        QPoint goal = path.last();
+        scene->addRect(goal.x() * cellSize + 3, goal.y() * cellSize + 3, cellSize - 6, cellSize - 6,
+                       QPen(color, 2), Qt::NoBrush);
+
+        // 已走过的轨迹
+        QPen trailPen(QColor(color.red(), color.green(), color.blue(), 120));
+        trailPen.setWidth(3);
+        for (int t = 1; t <= last; ++t) {
+            QPointF p1(path[t - 1].x() * cellSize + cellSize / 2.0, path[t - 1].y() * cellSize + cellSize / 2.0);
+            QPointF p2(path[t].x() * cellSize + cellSize / 2.0, path[t].y() * cellSize + cellSize / 2.0);
+            scene->addLine(QLineF(p1, p2), trailPen);
+        }
+
+        // 当前位置：实心圆点
+        QPoint pos = path[last];
+        scene->addEllipse(pos.x() * cellSize + 4, pos.y() * cellSize + 4, cellSize - 8, cellSize - 8,
+                          QPen(color), QBrush(color));
     }
 }
 
@@ -265,8 +260,7 @@ void MainWindow::drawPath(const QStack<QPoint> &path) {
 // mainwindow.cpp
 void MainWindow::mousePressEvent(QMouseEvent *event) {
     // 只有在左键点击且处于设置起点/终点模式时才处理
-    if (event->button() != Qt::LeftButton ||
-        (currentEditMode != EditMode::SetStart && currentEditMode != EditMode::SetEnd)) {
+    if (event->button() != Qt::LeftButton || currentEditMode == EditMode::None) {
         QMainWindow::mousePressEvent(event); // 调用基类的事件处理，让其他事件正常传递
         return;
     }
@@ -299,6 +293,45 @@ void MainWindow::mousePressEvent(QMouseEvent *event) {
         return;
     }
 
+    // 编辑墙壁：在墙壁和通路之间切换，保持编辑模式以便连续编辑
+    if (currentEditMode == EditMode::ToggleWall) {
+        if (QPoint(col, row) == startPoint || QPoint(col, row) == endPoint) {
+            QMessageBox::warning(this, "警告", "不能把起点或终点改为墙壁！");
+            return;
+        }
+        maze[row][col] = (maze[row][col] == 1) ? 0 : 1;
+        if (maze[row][col] == 1)
+            goalPoints.removeAll(QPoint(col, row)); // 改为墙壁的单元格不再作为目标点
+        onCellChanged(QPoint(col, row));
+
+        // 迷宫已改变，之前找到的路径不再有效
+        animationTimer->stop();
+        animatedPath.clear();
+        allPaths.clear();
+        agentPaths.clear();
+        pathIndex = -1;
+        drawMaze();
+        ui->statusbar->showMessage(QString("(%1,%2) 已改为%3。").arg(col).arg(row)
+                                       .arg(maze[row][col] == 1 ? "墙壁" : "通路"), 3000);
+        return;
+    }
+
+    // 编辑目标点：点击通路增加或删除一个目标点，保持编辑模式以便连续编辑
+    if (currentEditMode == EditMode::ToggleGoal) {
+        if (maze[row][col] == 1) {
+            QMessageBox::warning(this, "警告", "不能把目标点设置在墙壁上！请点击通路。");
+            return;
+        }
+        const QPoint cell(col, row);
+        if (goalPoints.contains(cell))
+            goalPoints.removeAll(cell);
+        else
+            goalPoints.append(cell);
+        drawMaze();
+        ui->statusbar->showMessage(QString("共 %1 个目标点。").arg(goalPoints.size()), 3000);
+        return;
+    }
+
     // 检查是否是墙壁
     // maze 是二维 QVector 的话，需要使用 maze[row][col]
     if (maze[row][col] == 1) {
@@ -336,166 +369,111 @@ void MainWindow::mousePressEvent(QMouseEvent *event) {
 
 
 
-// 启发函数（曼哈顿距离）
-int MainWindow::heuristic(const QPoint &a, const QPoint &b) {
-    return std::abs(a.x() - b.x()) + std::abs(a.y() - b.y()); // 计算两点之间的曼哈顿距离
+// 当前迷宫的只读视图（maze 数组的行间隔为 MAX_COLS）
+MazeView MainWindow::mazeView() const {
+    return MazeView(&maze[0][0], rows, cols, MAX_COLS);
 }
 
-// A* 寻路算法
-// A* 寻路算法 (已修正)
-bool MainWindow::aStar(QStack<QPoint> &path, const QVector<QPoint> &blocked) {
-    std::priority_queue<Node*, std::vector<Node*>, CompareNode> open;
-    std::map<QPoint, Node*, QPointLess> allNodes; // 使用 std::map 存储 QPoint 键
-
-    Node* startNode = new Node(startPoint, 0, heuristic(startPoint, endPoint));
-    open.push(startNode);
-    allNodes[startPoint] = startNode;
-
-    Node* endNode = nullptr;
-
-    while (!open.empty()) {
-        Node* current = open.top();
-        open.pop();
-
-        // 这是一个优化，如果从优先队列中取出的节点不是到达该点的最优路径，则跳过
-        // （因为一个更优的路径已经被处理过了）
-        auto it = allNodes.find(current->pos);
-        if (it != allNodes.end() && current->f > it->second->f) {
-            // 这个current节点是一个被更优路径取代的旧节点，可以直接忽略。
-            // 注意：这里不要 delete current，因为它会在最后的统一清理中被释放。
-            continue;
-        }
-
-        if (current->pos == endPoint) {
-            endNode = current;
-            break; // 找到终点，退出循环
-        }
-
-        // 探索邻居节点
-        for (QPoint d : {QPoint(0,1), QPoint(1,0), QPoint(0,-1), QPoint(-1,0)}) { // 四个方向
-            QPoint next = current->pos + d;
-            int x = next.x(), y = next.y();
-
-            // 边界检查、墙壁检查、阻塞点检查
-            if (x < 0 || x >= cols || y < 0 || y >= rows || maze[y][x] == 1 || blocked.contains(next)) {
-                continue;
-            }
-
-            int tentative_gScore = current->g + 1;
-
-            Node* neighborNode = nullptr;
-            auto it2 = allNodes.find(next);
-            if (it2 != allNodes.end()) {
-                neighborNode = it2->second;
-            }
-
-            // 如果是新节点，或者找到了到邻居节点的更短路径
-            if (!neighborNode || tentative_gScore < neighborNode->g) {
-                if (neighborNode) {
-                    // 更新现有节点信息
-                    neighborNode->parent = current;
-                    neighborNode->g = tentative_gScore;
-                    neighborNode->f = neighborNode->g + heuristic(neighborNode->pos, endPoint);
-                    open.push(neighborNode); // 将更新后的节点重新放入优先队列
-                } else {
-                    // 创建新节点
-                    Node* newNode = new Node(next, tentative_gScore, heuristic(next, endPoint), current);
-                    allNodes[next] = newNode;
-                    open.push(newNode);
-                }
-            }
-        }
+// 根据界面上的选择生成寻路选项
+SolverOptions MainWindow::solverOptions() const {
+    SolverOptions options;
+    options.neighborhood = ui->cmbNeighborhood->currentIndex() == 1 ? Neighborhood::Eight : Neighborhood::Four;
+    switch (ui->cmbHeuristic->currentIndex()) {
+    case 1: options.heuristic = HeuristicKind::Octile; break;
+    case 2: options.heuristic = HeuristicKind::Zero; break;
+    default: options.heuristic = HeuristicKind::Manhattan; break;
     }
+    return admissibleOptions(options); // 在 8 邻域下又手动选回曼哈顿距离时，仍改用八方向距离
+}
 
-    // --- 以下是核心修正区域 ---
-
-    bool pathFound = (endNode != nullptr);
-
-    // 步骤 1: 如果找到了路径，先重建它
-    if (pathFound) {
-        // 重构路径：从终点节点回溯到起点节点
-        // 因为我们是把 QPoint (值) 压入栈，所以即使稍后 Node* 被 delete，路径数据也是安全的。
+// A* 寻路算法
+// 具体实现见 pathsolver.h：findPath 是唯一的分派点，按邻域和启发函数选择模板实例
+// 路径直接以紧凑编码写入 path，不经过中间的坐标栈
+// 起终点不在同一连通区域时直接返回，不必搜索整个可达区域才发现找不到
+// 没有阻塞点时先查询缓存（pathcache.h）
+bool MainWindow::aStar(CompactPath &path, const QVector<QPoint> &blocked) {
+    if (!components.connected(mazeView(), startPoint, endPoint)) {
         path.clear();
-        QStack<QPoint> reversePath;
-        Node* node = endNode;
-        while (node) {
-            reversePath.push(node->pos); // 将节点位置压入栈
-            node = node->parent;         // 移向父节点
-        }
-
-        // 将反向路径栈转换为正向路径
-        while (!reversePath.isEmpty()) {
-            path.push(reversePath.pop());
-        }
+        return false;
     }
+    if (blocked.isEmpty())
+        return pathCache.solve(mazeView(), startPoint, endPoint, solverOptions(), solverWorkspace, path);
+    return findPath(mazeView(), startPoint, endPoint, solverOptions(), solverWorkspace, path, blocked);
+}
 
-    // 步骤 2: 无论是否找到路径，最后统一清理所有分配的内存
-    for (auto const& [key, val] : allNodes) {
-        delete val;
+// 最近一次寻路的来源和缓存命中率
+QString MainWindow::searchStatsText() const {
+    QString sourceText;
+    switch (pathCache.lastSource()) {
+    case PathCache::Source::Hit: sourceText = "缓存命中"; break;
+    case PathCache::Source::TreeHit: sourceText = "最短路径树命中"; break;
+    case PathCache::Source::Miss: sourceText = QString("扩展 %1 个单元格").arg(solverWorkspace.expanded); break;
     }
-    allNodes.clear(); // 清空 map
+    return QString("%1，缓存命中率 %2%").arg(sourceText).arg(pathCache.stats().hitRate() * 100.0, 0, 'f', 1);
+}
+
+// 迷宫整体改变（生成或加载）：重新计算内容哈希（哈希变化时缓存自动失效），重新标记连通区域
+void MainWindow::onMazeChanged() {
+    pathCache.setMazeHash(PathCache::hashMaze(mazeView()));
+    components.build(mazeView(), generatorThreads);
+}
 
-    // 步骤 3: 返回结果
-    return pathFound;
+// 单个单元格在墙壁和通路之间切换：增量更新内容哈希和连通区域
+void MainWindow::onCellChanged(const QPoint &cell) {
+    pathCache.setMazeHash(pathCache.mazeHash() ^ PathCache::cellHash(mazeView().index(cell)));
+    if (mazeView().isOpen(cell))
+        components.cellOpened(mazeView(), cell);
+    else
+        components.cellClosed(mazeView(), cell);
 }
 
 
 // 查找所有路径函数（使用DFS）
-// 注意：对于大型迷宫和多条路径，此函数可能非常耗时且消耗大量内存。
-// 限制paths.size()是一个简单的保护措施。
-bool MainWindow::findAllPaths(QPoint start, QVector<QPoint> &currentVisitedPath, QVector<QVector<QPoint>> &paths) {
+// 注意：对于大型迷宫和多条路径，此函数可能非常耗时。
+// 找到的路径存入前缀共享的 PathTrie，公共前缀只存一次；限制路径条数是一个简单的保护措施。
+// onPath 按单元格标记当前路径上的点，O(1) 判断是否成环
+void MainWindow::findAllPaths(const QPoint &cell, std::vector<char> &onPath, PathTrie &paths) {
     // 终止条件：如果当前点是终点
-    if (start == endPoint) {
-        paths.append(currentVisitedPath); // 将当前路径添加到所有路径列表中
-        return true;
+    if (cell == endPoint) {
+        paths.commit(); // 只为与已有路径不同的后缀分配编码
+        return;
     }
 
     // 限制查找的路径数量，防止过度计算/内存消耗
     if (paths.size() > 2000) { // 限制为 2000 条路径
-        return false; // 达到限制，不再继续查找
+        return; // 达到限制，不再继续查找
     }
 
-    // 定义四个方向
-    QVector<QPoint> directions = {QPoint(0,1), QPoint(1,0), QPoint(0,-1), QPoint(-1,0)};
-    for (QPoint d : directions) {
-        QPoint next = start + d; // 计算下一个点的位置
+    // 四个方向取自 FourConnected 的编译期方向表，不在每层递归中重新构造
+    for (int k = 0; k < FourConnected::kCount; ++k) {
+        QPoint next = cell + QPoint(FourConnected::dx[k], FourConnected::dy[k]); // 计算下一个点的位置
         int x = next.x(), y = next.y();
 
         // 边界检查、墙壁检查、避免当前路径中的循环
         if (x < 0 || x >= cols || y < 0 || y >= rows) continue; // 超出边界
         if (maze[y][x] == 1) continue; // 是墙壁
-        if (currentVisitedPath.contains(next)) continue; // 避免在当前路径中形成循环
+        if (onPath[y * cols + x]) continue; // 避免在当前路径中形成循环
 
-        currentVisitedPath.append(next); // 将下一个点添加到当前访问路径
-        findAllPaths(next, currentVisitedPath, paths); // 递归调用，探索新分支
-        currentVisitedPath.removeLast(); // 回溯：移除当前点，以便探索其他分支
+        onPath[y * cols + x] = 1;
+        paths.push(k); // 方向编码与 FourConnected 的下标一致
+        findAllPaths(next, onPath, paths); // 递归调用，探索新分支
+        paths.pop(); // 回溯：撤销这一步，以便探索其他分支
+        onPath[y * cols + x] = 0;
     }
-    return !paths.isEmpty(); // 返回是否找到至少一条路径
 }
 
 // 从文件加载迷宫
 bool MainWindow::loadMazeFromFile(const QString &filePath) {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // 文件无法打开
-        QMessageBox::warning(this, "错误", "无法打开文件。");
-        return false;
-    }
-
-    QTextStream in(&file);
-    QStringList lines;
-    while (!in.atEnd()) {
-        lines.append(in.readLine().trimmed()); // 读取每行并去除空白字符
-    }
-    file.close();
-
-    if (lines.isEmpty()) {
-        QMessageBox::warning(this, "错误", "文件为空。");
+    // 解析文件（见 mazeio.h），出错时显示具体原因
+    MazeGrid grid;
+    QString error;
+    if (!loadMazeText(filePath, grid, &error)) {
+        QMessageBox::warning(this, "错误", error);
         return false;
     }
 
-    int r = lines.size(); // 行数
-    int c = lines[0].length(); // 列数 (以第一行长度为准)
+    int r = grid.rows; // 行数
+    int c = grid.cols; // 列数
 
     // 检查迷宫尺寸是否超出最大限制
     if (r > MAX_ROWS || c > MAX_COLS) {
@@ -503,42 +481,23 @@ bool MainWindow::loadMazeFromFile(const QString &filePath) {
         return false;
     }
 
-    // 解析文件内容到maze数组
-    for (int i = 0; i < r; ++i) {
-        if (lines[i].length() != c) {
-            QMessageBox::warning(this, "错误", "文件格式不正确：行长度不一致。");
-            return false;
-        }
-        for (int j = 0; j < c; ++j) {
-            QChar ch = lines[i][j];
-            if (ch == '0')
-                maze[i][j] = 0; // '0' 表示通路
-            else if (ch == '1')
-                maze[i][j] = 1; // '1' 表示墙壁
-            else {
-                QMessageBox::warning(this, "错误", QString("文件格式不正确：包含非法字符 '%1'。").arg(ch));
-                return false;
-            }
-        }
-    }
-    rows = r; cols = c; // 更新迷宫的实际行数和列数
-
-    // 默认设置起点和终点
-    startPoint = QPoint(0, 0);
-    endPoint = QPoint(cols - 1, rows - 1);
+    // 先在解析出的 grid 上选好起点和终点：没有通路时直接返回，maze、rows、cols 以及
+    // 依赖它们的连通区域和内容哈希都还是旧迷宫的，保持一致
+    const MazeView view = grid.view();
+    QPoint start(0, 0);
+    QPoint end(c - 1, r - 1);
 
     // 确保加载后起点是可走的路径
-    if (maze[startPoint.y()][startPoint.x()] == 1) {
+    if (!view.isOpen(start)) {
         bool foundStart = false;
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (maze[i][j] == 0) { // 找到第一个通路作为起点
-                    startPoint = QPoint(j, i);
+        for (int i = 0; i < r && !foundStart; ++i) {
+            for (int j = 0; j < c; ++j) {
+                if (view.isOpen(j, i)) { // 找到第一个通路作为起点
+                    start = QPoint(j, i);
                     foundStart = true;
                     break;
                 }
             }
-            if (foundStart) break;
         }
         if (!foundStart) {
             QMessageBox::warning(this, "警告", "加载的迷宫中没有通路！无法设置起点。");
@@ -546,44 +505,51 @@ bool MainWindow::loadMazeFromFile(const QString &filePath) {
         }
     }
 
-    // 确保加载后终点是可走的路径
-    if (maze[endPoint.y()][endPoint.x()] == 1) {
+    // 确保加载后终点是可走的路径（起点找到时终点一定也能找到）
+    if (!view.isOpen(end)) {
         bool foundEnd = false;
-        for (int i = rows - 1; i >= 0; --i) { // 从右下角开始找
-            for (int j = cols - 1; j >= 0; --j) {
-                if (maze[i][j] == 0) { // 找到最后一个通路作为终点
-                    endPoint = QPoint(j, i);
+        for (int i = r - 1; i >= 0 && !foundEnd; --i) { // 从右下角开始找
+            for (int j = c - 1; j >= 0; --j) {
+                if (view.isOpen(j, i)) { // 找到最后一个通路作为终点
+                    end = QPoint(j, i);
                     foundEnd = true;
                     break;
                 }
             }
-            if (foundEnd) break;
-        }
-        if (!foundEnd) {
-            QMessageBox::warning(this, "警告", "加载的迷宫中没有通路！无法设置终点。");
-            return false;
         }
     }
 
+    // 复制到maze数组
+    for (int i = 0; i < r; ++i)
+        for (int j = 0; j < c; ++j)
+            maze[i][j] = grid.cells[i * c + j];
+    rows = r; cols = c; // 更新迷宫的实际行数和列数
+    startPoint = start;
+    endPoint = end;
+
     // 清空之前的路径和动画状态，因为迷宫已改变
     blockedPoints.clear();
-    currentPath.clear();
+    goalPoints.clear(); // 目标点可能落在新迷宫的墙壁上
+    animatedPath.clear();
     allPaths.clear();
+    agentPaths.clear();
     pathIndex = -1;
     animationIndex = 0;
 
+    onMazeChanged();
+
     return true; // 迷宫加载成功
 }
 
 // 启动路径动画函数
-void MainWindow::startPathAnimation(const QVector<QPoint> &path)
+void MainWindow::startPathAnimation(CompactPath path)
 {
     if (animationTimer->isActive())
         animationTimer->stop(); // 如果计时器正在运行，先停止
 
-    animatedPath = path; // 设置要动画的路径
-    animationIndex = 0; // 重置动画步数
-    currentPath.clear(); // 清空当前绘制的路径
+    animatedPath = std::move(path); // 接管要动画的路径
+    agentPaths.clear(); // 单条路径动画，退出多机器人模式
+    animationIndex = 0; // 重置动画步数（已绘制的点数）
 
     if (!animatedPath.isEmpty()) {
         animationTimer->start(80);  // 启动计时器，每80毫秒触发一次onAnimationStep
@@ -595,28 +561,48 @@ void MainWindow::startPathAnimation(const QVector<QPoint> &path)
 // 动画步进函数
 void MainWindow::onAnimationStep()
 {
+    // 多机器人模式：每一步推进一个时刻，所有机器人同时移动
+    if (!agentPaths.isEmpty()) {
+        int makespan = 0;
+        for (const QVector<QPoint> &p : agentPaths)
+            makespan = std::max(makespan, static_cast<int>(p.size()));
+        if (animationIndex >= makespan) {
+            animationTimer->stop();
+            return;
+        }
+        drawAgents(animationIndex);
+        animationIndex++;
+        return;
+    }
+
     if (animationIndex >= animatedPath.size()) {
         animationTimer->stop(); // 动画播放完毕，停止计时器
         return;
     }
 
-    currentPath.push(animatedPath[animationIndex]); // 将当前步的路径点加入绘制列表
-    animationIndex++; // 动画步数加一
+    animationIndex++; // 动画步数加一，多绘制一个路径点
 
-    drawPath(currentPath); // 绘制当前动画状态的路径
+    drawPath(animatedPath, animationIndex); // 绘制当前动画状态的路径
 }
 
 // "生成迷宫"按钮点击槽函数
 void MainWindow::on_btnGenerate_clicked()
 {
+    QElapsedTimer timer;
+    timer.start();
     generateMaze(rows, cols); // 根据当前行、列数生成新迷宫
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
     drawMaze(); // 绘制新迷宫
-    ui->statusbar->showMessage("迷宫已生成。", 3000); // 状态栏提示
+    int threads = generatorThreads > 0 ? generatorThreads : MazeGenerator::defaultThreadCount();
+    ui->statusbar->showMessage(QString("迷宫已生成（种子 %1，%2 线程，用时 %3 微秒）。")
+                                   .arg(mazeSeed).arg(threads).arg(elapsedUs), 3000); // 状态栏提示
 }
 
 // "设置起点"按钮点击槽函数
 void MainWindow::on_btnSetStart_clicked()
 {
+    ui->btnEditWall->setChecked(false); // 退出墙壁编辑
+    ui->btnEditGoals->setChecked(false); // 退出目标点编辑
     currentEditMode = EditMode::SetStart; // 设置编辑模式为设置起点
     ui->statusbar->showMessage("点击通路设置起点...", 3000); // 状态栏提示
 }
@@ -624,6 +610,8 @@ void MainWindow::on_btnSetStart_clicked()
 // "设置终点"按钮点击槽函数
 void MainWindow::on_btnSetEnd_clicked()
 {
+    ui->btnEditWall->setChecked(false); // 退出墙壁编辑
+    ui->btnEditGoals->setChecked(false); // 退出目标点编辑
     currentEditMode = EditMode::SetEnd; // 设置编辑模式为设置终点
     ui->statusbar->showMessage("点击通路设置终点...", 3000); // 状态栏提示
 }
@@ -631,8 +619,9 @@ void MainWindow::on_btnSetEnd_clicked()
 // "清除路径"按钮点击槽函数
 void MainWindow::on_btnClearPath_clicked()
 {
-    currentPath.clear(); // 清空当前绘制路径
+    animatedPath.clear(); // 清空当前绘制路径
     allPaths.clear(); // 清空所有找到的路径
+    agentPaths.clear(); // 清空多机器人路径
     blockedPoints.clear(); // 清除可能的阻塞点（如果未来有此功能）
     pathIndex = -1; // 重置路径索引
     animationTimer->stop(); // 停止任何正在进行的动画
@@ -643,7 +632,6 @@ void MainWindow::on_btnClearPath_clicked()
 // "寻找最短路径"按钮点击槽函数 (使用A*算法)
 void MainWindow::on_btnFindPath_clicked()
 {
-    currentPath.clear();
     blockedPoints.clear();
     allPaths.clear(); // 确保清空所有路径，因为这是查找最短路径
     pathIndex = -1;
@@ -658,9 +646,15 @@ void MainWindow::on_btnFindPath_clicked()
     }
 
     // 调用A*算法查找最短路径
-    if (aStar(currentPath, blockedPoints)) {
-        startPathAnimation(currentPath.toVector()); // 找到路径则启动动画
-        ui->statusbar->showMessage(QString("找到最短路径，共 %1 步。").arg(currentPath.size()), 5000);
+    CompactPath path;
+    if (aStar(path, blockedPoints)) {
+        int steps = path.size();
+        startPathAnimation(std::move(path)); // 找到路径则启动动画，路径移交给动画，不再复制
+        ui->statusbar->showMessage(QString("找到最短路径，共 %1 步（%2）。")
+                                       .arg(steps).arg(searchStatsText()), 5000);
+    } else if (!components.connected(mazeView(), startPoint, endPoint)) {
+        QMessageBox::information(this, "提示", "起点和终点位于互不连通的区域，找不到路径！");
+        drawMaze();
     } else {
         QMessageBox::information(this, "提示", "找不到路径！请检查起终点或迷宫结构。");
         drawMaze(); // 未找到路径，只重绘迷宫
@@ -675,8 +669,6 @@ void MainWindow::on_btnNextPath_clicked()
     // 如果还没有找到所有路径，则先查找
     if (allPaths.isEmpty() || pathIndex == -1) {
         allPaths.clear(); // 确保查找所有路径时是一个干净的状态
-        QVector<QPoint> currentVisitedPathForDFS;
-        currentVisitedPathForDFS.append(startPoint); // DFS从起点开始
 
         // 检查起点和终点是否在迷宫范围内且是通路
         if (startPoint.y() < 0 || startPoint.y() >= rows || startPoint.x() < 0 || startPoint.x() >= cols || maze[startPoint.y()][startPoint.x()] == 1 ||
@@ -686,12 +678,21 @@ void MainWindow::on_btnNextPath_clicked()
             return;
         }
 
-        findAllPaths(startPoint, currentVisitedPathForDFS, allPaths); // 调用DFS查找所有路径
+        // 起终点不连通时 DFS 会枚举起点所在区域内的所有简单路径后才失败，耗时呈指数增长，这里直接拒绝
+        if (!components.connected(mazeView(), startPoint, endPoint)) {
+            QMessageBox::information(this, "提示", "起点和终点位于互不连通的区域，找不到任何路径！");
+            pathIndex = -1;
+            return;
+        }
+
+        // DFS从起点开始，路径存入以起点为根的前缀树
+        allPaths.reset(startPoint, 2);
+        std::vector<char> onPath(static_cast<size_t>(rows) * cols, 0);
+        onPath[startPoint.y() * cols + startPoint.x()] = 1;
+        findAllPaths(startPoint, onPath, allPaths); // 调用DFS查找所有路径
 
-        // 按长度对找到的路径进行排序 (最短的在前)
-        std::sort(allPaths.begin(), allPaths.end(), [](const QVector<QPoint>& a, const QVector<QPoint>& b) {
-            return a.size() < b.size();
-        });
+        // 按长度对找到的路径进行排序 (最短的在前)，只重排路径编号，不复制路径
+        allPaths.sortByLength();
 
         if (allPaths.isEmpty()) {
             QMessageBox::information(this, "提示", "找不到任何路径！请检查起终点或迷宫结构。");
@@ -708,17 +709,20 @@ void MainWindow::on_btnNextPath_clicked()
         pathIndex++; // 移动到下一条路径
     }
 
-    startPathAnimation(allPaths[pathIndex]); // 启动当前路径的动画
+    startPathAnimation(allPaths.path(pathIndex)); // 只在播放时把当前路径从前缀树展开为紧凑路径
 
-    QString info = QString("当前为第 %1 条路径，共 %2 步。")
+    QString info = QString("当前为第 %1 条路径，共 %2 步（%3 条路径共享前缀存储占 %4 KB，逐条存储需 %5 KB）。")
                        .arg(pathIndex + 1)
-                       .arg(allPaths[pathIndex].size());
+                       .arg(allPaths.steps(pathIndex) + 1)
+                       .arg(allPaths.size())
+                       .arg(allPaths.memoryBytes() / 1024.0, 0, 'f', 1)
+                       .arg(allPaths.flatMemoryBytes() / 1024.0, 0, 'f', 1);
     ui->statusbar->showMessage(info, 5000); // 状态栏显示当前路径信息
 }
 
 // "显示最短路径"按钮点击槽函数 (直接绘制最短路径，不动画)
 void MainWindow::on_btnShortest_clicked() {
-    currentPath.clear();
+    animatedPath.clear();
     blockedPoints.clear();
     allPaths.clear();
     pathIndex = -1;
@@ -733,9 +737,14 @@ void MainWindow::on_btnShortest_clicked() {
     }
 
     // 调用A*算法查找最短路径
-    if (aStar(currentPath, blockedPoints)) {
-        drawPath(currentPath); // 直接绘制最短路径，不进行动画
-        ui->statusbar->showMessage(QString("找到最短路径，共 %1 步。").arg(currentPath.size()), 5000);
+    if (aStar(animatedPath, blockedPoints)) {
+        agentPaths.clear(); // 退出多机器人模式
+        drawPath(animatedPath); // 直接绘制最短路径，不进行动画
+        ui->statusbar->showMessage(QString("找到最短路径，共 %1 步（%2）。")
+                                       .arg(animatedPath.size()).arg(searchStatsText()), 5000);
+    } else if (!components.connected(mazeView(), startPoint, endPoint)) {
+        QMessageBox::information(this, "提示", "起点和终点位于互不连通的区域，找不到最短路径！");
+        drawMaze();
     } else {
         QMessageBox::information(this, "提示", "找不到最短路径！请检查起终点或迷宫结构。");
         drawMaze(); // 未找到路径，只重绘迷宫
@@ -752,10 +761,129 @@ void MainWindow::on_btnLoad_clicked()
     // 尝试从文件加载迷宫
     if (loadMazeFromFile(filePath)) {
         drawMaze(); // 加载成功则绘制迷宫
-        ui->statusbar->showMessage("迷宫加载成功！", 3000);
+        ui->statusbar->showMessage(QString("迷宫加载成功！共 %1 个连通区域。").arg(components.componentCount()), 3000);
     } else {
         // 加载失败时，loadMazeFromFile会弹出具体错误信息
         // 这里可以给一个通用的失败提示
         QMessageBox::warning(this, "错误", "迷宫加载失败。");
     }
 }
+
+// "多机器人寻路"按钮点击槽函数 (随机放置多个机器人，协同规划后同步播放动画)
+void MainWindow::onMultiAgentClicked()
+{
+    animationTimer->stop();
+    animatedPath.clear();
+    allPaths.clear();
+    pathIndex = -1;
+
+    // 收集所有通路单元格并打乱，前 2N 个分别作为 N 个机器人的起点和目标
+    QVector<QPoint> openCells;
+    for (int y = 0; y < rows; ++y)
+        for (int x = 0; x < cols; ++x)
+            if (maze[y][x] != 1)
+                openCells.append(QPoint(x, y));
+    for (int i = openCells.size() - 1; i > 0; --i)
+        std::swap(openCells[i], openCells[QRandomGenerator::global()->bounded(i + 1)]);
+
+    int n = std::min(agentCount, static_cast<int>(openCells.size()) / 2);
+    if (n <= 0) {
+        QMessageBox::information(this, "提示", "迷宫中没有足够的通路放置机器人！");
+        return;
+    }
+
+    QVector<AgentTask> tasks;
+    for (int i = 0; i < n; ++i)
+        tasks.append(AgentTask{openCells[2 * i], openCells[2 * i + 1]});
+
+    QElapsedTimer timer;
+    timer.start();
+    MultiAgentPlanner planner(mazeView());
+    MultiAgentPlanner::Stats stats = planner.plan(tasks, agentPaths);
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+
+    if (stats.planned == 0) {
+        agentPaths.clear();
+        QMessageBox::information(this, "提示", "所有机器人都无法规划出无冲突路径！");
+        drawMaze();
+        return;
+    }
+
+    animationIndex = 0;
+    animationTimer->start(80); // 与单条路径动画使用同一个计时器
+
+    // 多机器人规划总是按 4 邻域进行（见 multiagentplanner.h），与界面上选择的邻域无关，在提示中说明
+    ui->statusbar->showMessage(QString("已按 4 邻域规划 %1/%2 个机器人，用时 %3 微秒，最长 %4 步，扩展 %5 个状态。")
+                                   .arg(stats.planned).arg(n).arg(elapsedUs)
+                                   .arg(stats.makespan).arg(stats.expansions), 5000);
+}
+
+// "编辑墙壁"按钮勾选状态改变槽函数
+void MainWindow::onEditWallToggled(bool checked)
+{
+    if (checked) {
+        ui->btnEditGoals->setChecked(false); // 两种编辑模式互斥
+        currentEditMode = EditMode::ToggleWall;
+        ui->statusbar->showMessage("点击单元格在墙壁和通路之间切换，再次点击按钮退出编辑。", 3000);
+    } else if (currentEditMode == EditMode::ToggleWall) {
+        currentEditMode = EditMode::None;
+        ui->statusbar->showMessage("已退出墙壁编辑。", 3000);
+    }
+}
+
+// "编辑目标点"按钮切换槽函数
+void MainWindow::onEditGoalsToggled(bool checked)
+{
+    if (checked) {
+        ui->btnEditWall->setChecked(false); // 两种编辑模式互斥
+        currentEditMode = EditMode::ToggleGoal;
+        ui->statusbar->showMessage("点击通路增加或删除目标点，再次点击按钮退出编辑。", 3000);
+    } else if (currentEditMode == EditMode::ToggleGoal) {
+        currentEditMode = EditMode::None;
+        ui->statusbar->showMessage(QString("已退出目标点编辑，共 %1 个目标点。").arg(goalPoints.size()), 3000);
+    }
+}
+
+// "最近目标"按钮点击槽函数 (从起点出发，一次多目标搜索找到最近的目标点并播放动画)
+void MainWindow::onNearestGoalClicked()
+{
+    animationTimer->stop();
+    allPaths.clear();
+    pathIndex = -1;
+
+    const MazeView view = mazeView();
+    if (!view.isOpen(startPoint)) {
+        QMessageBox::warning(this, "错误", "起点不在迷宫范围内或为墙壁，无法查找路径。请重新设置。");
+        return;
+    }
+    if (goalPoints.isEmpty()) {
+        QMessageBox::information(this, "提示", "还没有目标点！请先用\"编辑目标点\"添加。");
+        return;
+    }
+
+    // 与起点不连通的目标点不可能到达，不放入目标集合
+    QVector<QPoint> reachable;
+    for (const QPoint &g : goalPoints)
+        if (components.connected(view, startPoint, g))
+            reachable.append(g);
+    if (reachable.isEmpty()) {
+        QMessageBox::information(this, "提示", "所有目标点都与起点位于互不连通的区域，找不到路径！");
+        drawMaze();
+        return;
+    }
+
+    const GoalSet goals(view, reachable);
+    CompactPath path;
+    NearestResult result;
+    if (findNearest(view, {startPoint}, goals, solverOptions(), solverWorkspace, path, &result)) {
+        const QPoint goal = reachable[result.goal];
+        const int steps = path.size();
+        startPathAnimation(std::move(path));
+        ui->statusbar->showMessage(QString("最近的目标点为 (%1,%2)，共 %3 步（%4 个可达目标，扩展 %5 个单元格）。")
+                                       .arg(goal.x()).arg(goal.y()).arg(steps)
+                                       .arg(reachable.size()).arg(solverWorkspace.expanded), 5000);
+    } else {
+        QMessageBox::information(this, "提示", "找不到到达任何目标点的路径！");
+        drawMaze();
+    }
+}
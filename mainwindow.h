@@ -3,7 +3,6 @@
 
 #include <QMainWindow>
 #include <QGraphicsScene>
-#include <QStack>
 #include <QVector>
 #include <QPoint>
 #include <QTimer>
@@ -11,14 +10,17 @@
 #include <QGraphicsRectItem> // 绘制矩形项
 #include <QPixmap>          // 用于纹理
 #include <QBrush>           // 用于填充
-// #include <QMap>            // 替换为 std::map，需要 QPointLess 配合
 #include <QMessageBox>      // 消息框
 #include <QFileDialog>      // 文件对话框
 #include <QTextStream>      // 文本流
 #include <QPen>             // 画笔
 #include <QRandomGenerator> // 随机数生成器
 
-// 引入标准库，用于 A* 算法中的 std::priority_queue 和 std::map
+#include "multiagentplanner.h" // 多机器人协同寻路
+#include "pathsolver.h"        // 模板化 A* 寻路（4/8 邻域，多种启发函数）
+#include "pathcache.h"         // 寻路结果缓存
+#include "componentlabels.h"   // 连通区域标记
+#include "pathtrie.h"          // 前缀共享的路径存储
 
 
 QT_BEGIN_NAMESPACE
@@ -29,46 +31,13 @@ QT_END_NAMESPACE
 #define MAX_COLS 100
 #define cellSize 20// 定义单元格大小
 
-// 自定义 QPoint 比较器
-// 这是一个仿函数，用于 std::map 中 QPoint 键的排序
-// std::map 需要键是可排序的，QPoint 默认没有 operator<，所以需要自定义
-struct QPointLess {
-    bool operator()(const QPoint &p1, const QPoint &p2) const {
-        if (p1.x() != p2.x()) {
-            return p1.x() < p2.x();
-        }
-        return p1.y() < p2.y();
-    }
-};
-
-// Node 结构体，用于 A* 算法
-// 定义在头文件中，因为 A* 算法需要在 MainWindow 中使用
-struct Node {
-    QPoint pos;          // 节点位置
-    int g, h, f;         // g: 从起点到当前点的代价，h: 从当前点到终点的估计代价，f: g + h
-    Node* parent;        // 父节点指针，用于重构路径
-
-    // 构造函数
-    Node(QPoint p, int g_, int h_, Node* par = nullptr)
-        : pos(p), g(g_), h(h_), f(g_ + h_), parent(par) {}
-};
-
-// CompareNode 结构体，用于 A* 优先队列
-// 定义了Node指针的比较规则，使得优先队列按f值从小到大排序
-struct CompareNode {
-    bool operator()(const Node* a, const Node* b) const {
-        return a->f > b->f; // 返回true表示a的优先级低于b（f值更大），即小f值优先级高
-    }
-};
-
-
 class MainWindow : public QMainWindow
 {
     Q_OBJECT // 宏，必须存在于任何使用Qt元对象系统（信号和槽）的类中
 
 public:
-    // 定义编辑模式枚举，用于鼠标点击设置起点/终点
-    enum class EditMode { None, SetStart, SetEnd };
+    // 定义编辑模式枚举，用于鼠标点击设置起点/终点、切换墙壁或增删目标点
+    enum class EditMode { None, SetStart, SetEnd, ToggleWall, ToggleGoal };
 
     // 构造函数和析构函数
     MainWindow(QWidget *parent = nullptr);
@@ -84,6 +53,12 @@ private slots:
     void on_btnNextPath_clicked();
     void on_btnShortest_clicked();
     void on_btnLoad_clicked();
+    // "编辑墙壁""编辑目标点"是可勾选按钮，使用 toggled 信号手动连接（不使用 on_对象名_信号 命名，避免被自动连接后触发两次）
+    void onEditWallToggled(bool checked);
+    void onEditGoalsToggled(bool checked);
+    // 后来加入的按钮同样只手动连接 clicked 信号，槽函数不使用 on_对象名_信号 命名
+    void onMultiAgentClicked();
+    void onNearestGoalClicked();
 
     // 路径动画计时器槽函数
     void onAnimationStep();
@@ -103,7 +78,7 @@ private:
     int rows, cols;
     // 路径索引和动画索引
     int pathIndex = -1; // 当前显示的是allPaths中的哪条路径
-    int animationIndex = 0; // 动画当前进行到animatedPath的哪一步
+    int animationIndex = 0; // 动画当前已绘制animatedPath的前几个点
 
     QPoint startPoint; // 迷宫起点
     QPoint endPoint; // 迷宫终点
@@ -111,31 +86,46 @@ private:
     EditMode currentEditMode; // 当前的编辑模式
 
     int maze[MAX_ROWS][MAX_COLS] = {0}; // 迷宫数据：0-通路，1-墙壁，2-Prim算法中的前沿点（临时状态）
+    quint32 mazeSeed = 0; // 最近一次生成迷宫所用的随机种子
+    int generatorThreads = 0; // 生成迷宫的线程数，0 表示使用全部硬件线程
     QVector<QPoint> blockedPoints; // 暂时未使用的阻塞点列表，可用于将来扩展功能
+    QVector<QPoint> goalPoints; // 候选目标点（如充电桩、投放点），"最近目标"在其中一次搜索出最近的一个
 
-    QStack<QPoint> currentPath; // 当前绘制的路径（用于动画）
-    QVector<QVector<QPoint>> allPaths; // 存储找到的所有路径
+    PathTrie allPaths; // 存储找到的所有路径（前缀共享，播放时才展开）
 
     // 动画相关
+    SolverWorkspace solverWorkspace; // A* 搜索缓冲区，在多次寻路之间复用
+    PathCache pathCache; // 寻路结果缓存，迷宫内容改变时自动失效
+    ComponentLabels components; // 通路的连通区域，寻路前 O(1) 拒绝起终点不连通的查询
+
     QTimer *animationTimer; // 动画计时器
-    QVector<QPoint> animatedPath; // 正在进行动画的路径
+    CompactPath animatedPath; // 当前显示/正在进行动画的路径，从寻路结果移动而来
+    QVector<QVector<QPoint>> agentPaths; // 多机器人模式下各机器人的时空路径，非空时动画按时刻同步播放所有路径
+    int agentCount = 8; // 多机器人模式下随机放置的机器人数量
 
     // 迷宫生成和绘制函数
-    void generateMaze(int r, int c);
+    void generateMaze(int r, int c); // 调用 MazeGenerator 分块并行生成
     void drawMaze();
-    void drawPath(const QStack<QPoint> &path); // 绘制给定路径
+    void drawPath(const CompactPath &path, int count = -1); // 绘制给定路径的前count个点，-1表示全部
+    void drawAgents(int step); // 绘制所有机器人在 step 时刻的位置及其走过的轨迹
 
     // 寻路算法辅助函数
-    int heuristic(const QPoint &a, const QPoint &b); // A*启发函数
-    bool aStar(QStack<QPoint> &path, const QVector<QPoint> &blocked = {}); // A*寻路算法
-    // DFS查找所有路径：注意这里参数是引用，用于收集路径
-    bool findAllPaths(QPoint start, QVector<QPoint> &currentVisitedPath, QVector<QVector<QPoint>> &paths);
+    MazeView mazeView() const; // 当前迷宫的只读视图
+    SolverOptions solverOptions() const; // 根据界面上的邻域和启发函数选择生成寻路选项
+    bool aStar(CompactPath &path, const QVector<QPoint> &blocked = {}); // A*寻路算法
+    QString searchStatsText() const; // 最近一次寻路的来源（缓存/搜索）和缓存命中率，用于状态栏
+
+    // 迷宫内容改变后的通知：整体改变（生成/加载）和单个单元格改变（编辑）
+    void onMazeChanged();
+    void onCellChanged(const QPoint &cell);
+    // DFS查找所有路径：onPath 标记当前路径上的单元格，找到的路径存入 paths
+    void findAllPaths(const QPoint &cell, std::vector<char> &onPath, PathTrie &paths);
 
     // 文件操作函数
     bool loadMazeFromFile(const QString &filePath);
 
     // 路径动画启动函数
-    void startPathAnimation(const QVector<QPoint> &path);
+    void startPathAnimation(CompactPath path); // 按值接收，调用方用 std::move 交出路径
 };
 
 #endif // MAINWINDOW_H
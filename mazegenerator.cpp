@@ -0,0 +1,210 @@
+#include "mazegenerator.h"
+
+#include <QRandomGenerator>
+#include <QVector>
+#include <QPoint>
+
+#include <algorithm>   // std::fill, std::min, std::max
+#include <atomic>      // std::atomic
+#include <cmath>       // std::sqrt, std::ceil
+#include <thread>      // std::thread
+#include <vector>      // std::vector
+
+namespace {
+
+// 分块的最小边长（逻辑单元格数），避免小迷宫被切得过碎
+const int kMinTileSide = 16;
+// 每个线程对应的分块数，分块多于线程时可以平衡各线程的负载
+const int kTilesPerThread = 4;
+// 接缝阶段使用的种子编号，与任何分块编号都不相同
+const quint32 kStitchStream = 0xFFFFFFFFu;
+
+// 并查集查找（带路径压缩），用于在分块图上生成生成树
+int findRoot(std::vector<int> &parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+} // namespace
+
+int MazeGenerator::defaultThreadCount() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// 生成迷宫：分块生成 + 接缝拼接
+void MazeGenerator::generate(int *cells, int rows, int cols, int stride,
+                             quint32 seed, int threadCount) {
+    // 初始化所有单元格为墙壁 (1)
+    for (int y = 0; y < rows; ++y)
+        std::fill(cells + y * stride, cells + y * stride + cols, 1);
+
+    // 逻辑单元格：迷宫中坐标为 (2j+1, 2i+1) 的点
+    const int logicalRows = (rows - 1) / 2;
+    const int logicalCols = (cols - 1) / 2;
+    if (logicalRows <= 0 || logicalCols <= 0)
+        return;
+
+    if (threadCount <= 0)
+        threadCount = defaultThreadCount();
+
+    // 计算分块布局，单线程时整个迷宫就是一个分块（即原来的 Prim 算法）
+    int tilesY = 1, tilesX = 1;
+    if (threadCount > 1) {
+        const int maxTilesY = std::max(1, logicalRows / kMinTileSide);
+        const int maxTilesX = std::max(1, logicalCols / kMinTileSide);
+        const int target = threadCount * kTilesPerThread;
+        tilesX = std::min(maxTilesX, std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(target))))));
+        tilesY = std::min(maxTilesY, (target + tilesX - 1) / tilesX);
+    }
+
+    std::vector<Tile> tiles;
+    tiles.reserve(tilesY * tilesX);
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            Tile t;
+            t.row0 = ty * logicalRows / tilesY;
+            t.row1 = (ty + 1) * logicalRows / tilesY;
+            t.col0 = tx * logicalCols / tilesX;
+            t.col1 = (tx + 1) * logicalCols / tilesX;
+            tiles.push_back(t);
+        }
+    }
+
+    // 各分块互不重叠，线程只写入自己分块内的单元格，因此无需加锁
+    const int tileCount = static_cast<int>(tiles.size());
+    const int workerCount = std::min(threadCount, tileCount);
+    if (workerCount <= 1) {
+        for (int i = 0; i < tileCount; ++i)
+            generateTile(cells, stride, tiles[i], seed, static_cast<quint32>(i));
+    } else {
+        std::atomic<int> nextTile(0);
+        auto worker = [&]() {
+            for (int i = nextTile++; i < tileCount; i = nextTile++)
+                generateTile(cells, stride, tiles[i], seed, static_cast<quint32>(i));
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+        for (int i = 0; i < workerCount; ++i)
+            workers.emplace_back(worker);
+        for (std::thread &w : workers)
+            w.join();
+    }
+
+    if (tileCount <= 1)
+        return;
+
+    // 接缝拼接：在分块图上用随机 Kruskal 算法生成一棵生成树
+    struct TileEdge { int a, b; bool horizontal; };
+    std::vector<TileEdge> edges;
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            int id = ty * tilesX + tx;
+            if (tx + 1 < tilesX) edges.push_back({id, id + 1, true});       // 右侧相邻分块
+            if (ty + 1 < tilesY) edges.push_back({id, id + tilesX, false}); // 下方相邻分块
+        }
+    }
+
+    const quint32 stitchSeeds[2] = { seed, kStitchStream };
+    QRandomGenerator rng(stitchSeeds, 2);
+
+    // Fisher-Yates 洗牌
+    for (int i = static_cast<int>(edges.size()) - 1; i > 0; --i)
+        std::swap(edges[i], edges[rng.bounded(i + 1)]);
+
+    std::vector<int> parent(tileCount);
+    for (int i = 0; i < tileCount; ++i)
+        parent[i] = i;
+
+    for (const TileEdge &e : edges) {
+        int ra = findRoot(parent, e.a);
+        int rb = findRoot(parent, e.b);
+        if (ra == rb)
+            continue; // 已连通，再打通会形成环
+        parent[ra] = rb;
+
+        // 在两个分块的公共边上随机选一处打通墙壁
+        const Tile &ta = tiles[e.a];
+        const Tile &tb = tiles[e.b];
+        int x, y;
+        if (e.horizontal) {
+            x = 2 * tb.col0;
+            y = 2 * (ta.row0 + rng.bounded(ta.row1 - ta.row0)) + 1;
+        } else {
+            y = 2 * tb.row0;
+            x = 2 * (ta.col0 + rng.bounded(ta.col1 - ta.col0)) + 1;
+        }
+        cells[y * stride + x] = 0;
+    }
+}
+
+// 在单个分块内运行 Prim 算法
+void MazeGenerator::generateTile(int *cells, int stride, const Tile &tile, quint32 seed, quint32 tileIndex) {
+    // 每个分块使用独立的随机数生成器，种子由全局种子和分块编号共同决定
+    const quint32 seeds[2] = { seed, tileIndex };
+    QRandomGenerator rng(seeds, 2);
+
+    // 分块在迷宫坐标中的范围（只包含块内的逻辑单元格）
+    const int xMin = 2 * tile.col0 + 1, xMax = 2 * (tile.col1 - 1) + 1;
+    const int yMin = 2 * tile.row0 + 1, yMax = 2 * (tile.row1 - 1) + 1;
+
+    auto at = [&](int y, int x) -> int & { return cells[y * stride + x]; };
+    auto inTile = [&](int y, int x) {
+        return x >= xMin && x <= xMax && y >= yMin && y <= yMax;
+    };
+
+    QVector<QPoint> frontier; // 边界点（待处理的墙壁）列表
+
+    // 辅助lambda函数：将指定点添加到frontier列表
+    auto addFrontier = [&](int y, int x) {
+        if (inTile(y, x) && at(y, x) == 1) {
+            frontier.append(QPoint(x, y));
+            at(y, x) = 2; // 标记为“待处理前沿”，避免重复添加
+        }
+    };
+
+    // 随机选择分块内的一个逻辑单元格作为起点
+    const int sy = yMin + 2 * rng.bounded(tile.row1 - tile.row0);
+    const int sx = xMin + 2 * rng.bounded(tile.col1 - tile.col0);
+    at(sy, sx) = 0;
+    addFrontier(sy, sx + 2);
+    addFrontier(sy, sx - 2);
+    addFrontier(sy + 2, sx);
+    addFrontier(sy - 2, sx);
+
+    static const QPoint directions[] = {QPoint(0, 2), QPoint(0, -2), QPoint(2, 0), QPoint(-2, 0)};
+
+    while (!frontier.isEmpty()) {
+        // 随机选择一个边界点，与末尾元素交换后删除，避免 removeAt 的整体搬移
+        int idx = rng.bounded(static_cast<int>(frontier.size()));
+        QPoint f = frontier[idx];
+        frontier[idx] = frontier.last();
+        frontier.removeLast();
+
+        int x = f.x();
+        int y = f.y();
+
+        // 查找与当前前沿单元格相邻的已挖空路径单元格 (距离为2的通路)
+        QPoint neighbors[4];
+        int neighborCount = 0;
+        for (const QPoint &d : directions) {
+            int nx = x + d.x();
+            int ny = y + d.y();
+            if (inTile(ny, nx) && at(ny, nx) == 0)
+                neighbors[neighborCount++] = QPoint(nx, ny);
+        }
+
+        if (neighborCount > 0) {
+            QPoint n = neighbors[rng.bounded(neighborCount)];
+            at(y, x) = 0;                           // 挖空当前前沿单元格
+            at((y + n.y()) / 2, (x + n.x()) / 2) = 0; // 挖空当前和邻居之间的墙壁
+
+            addFrontier(y, x + 2);
+            addFrontier(y, x - 2);
+            addFrontier(y + 2, x);
+            addFrontier(y - 2, x);
+        }
+    }
+}
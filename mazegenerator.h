@@ -0,0 +1,38 @@
+#ifndef MAZEGENERATOR_H
+#define MAZEGENERATOR_H
+
+#include <QtGlobal>
+
+// 迷宫生成器（分块并行 Prim 算法）
+// 将迷宫的逻辑单元格（奇数坐标）划分为若干矩形分块，每个分块在独立线程中
+// 使用各自的随机数种子运行 Prim 算法，生成块内的完美迷宫；
+// 最后在分块图上随机生成一棵生成树，沿每条树边在分块接缝处打通一面墙，
+// 因此整个迷宫仍然是完美迷宫（任意两个通路单元格之间有且仅有一条路径）。
+// 对于相同的种子和线程数，生成结果完全确定，与线程调度顺序无关。
+class MazeGenerator
+{
+public:
+    // 生成迷宫
+    // cells: 迷宫数据首地址（行优先），0-通路，1-墙壁
+    // rows, cols: 迷宫行列数，必须为不小于 3 的奇数
+    // stride: 相邻两行在 cells 中的间隔（例如 MAX_COLS）
+    // seed: 随机数种子
+    // threadCount: 线程数，<= 0 时使用硬件支持的线程数；为 1 时即为普通的单线程 Prim 算法
+    static void generate(int *cells, int rows, int cols, int stride,
+                         quint32 seed, int threadCount = 0);
+
+    // 返回 threadCount <= 0 时实际使用的线程数
+    static int defaultThreadCount();
+
+private:
+    // 分块的逻辑单元格范围，[row0, row1) x [col0, col1)
+    struct Tile {
+        int row0, row1;
+        int col0, col1;
+    };
+
+    // 在单个分块内运行 Prim 算法
+    static void generateTile(int *cells, int stride, const Tile &tile, quint32 seed, quint32 tileIndex);
+};
+
+#endif // MAZEGENERATOR_H
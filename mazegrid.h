@@ -0,0 +1,54 @@
+#ifndef MAZEGRID_H
+#define MAZEGRID_H
+
+#include <QPoint>
+#include <QVector>
+
+// 迷宫网格只读视图
+// 不持有数据，只记录数据首地址、行列数和行间隔，
+// 使寻路算法既能作用于 MainWindow 中的 maze[MAX_ROWS][MAX_COLS] 数组（stride = MAX_COLS），
+// 也能作用于任意大小的连续缓冲区（stride = cols）。
+// 单元格编号统一为 y * stride + x，算法中按编号分配的辅助数组大小为 cellCount()。
+struct MazeView {
+    const int *cells = nullptr; // 迷宫数据首地址：0-通路，1-墙壁
+    int rows = 0;               // 行数
+    int cols = 0;               // 列数
+    int stride = 0;             // 相邻两行的间隔
+
+    MazeView() = default;
+    MazeView(const int *c, int r, int w, int s) : cells(c), rows(r), cols(w), stride(s) {}
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < cols && y >= 0 && y < rows; }
+    bool inBounds(const QPoint &p) const { return inBounds(p.x(), p.y()); }
+
+    // 是否为可通行单元格（越界视为不可通行）
+    bool isOpen(int x, int y) const { return inBounds(x, y) && cells[y * stride + x] != 1; }
+    bool isOpen(const QPoint &p) const { return isOpen(p.x(), p.y()); }
+
+    // 单元格编号与坐标互相转换
+    int index(int x, int y) const { return y * stride + x; }
+    int index(const QPoint &p) const { return index(p.x(), p.y()); }
+    QPoint point(int index) const { return QPoint(index % stride, index / stride); }
+
+    // 按编号分配辅助数组时需要的长度
+    int cellCount() const { return rows * stride; }
+};
+
+// 自带存储的迷宫网格（行优先，stride = cols）
+// 用于不依赖界面的场合，例如命令行批处理模式；尺寸不受 MAX_ROWS / MAX_COLS 限制。
+struct MazeGrid {
+    int rows = 0;
+    int cols = 0;
+    QVector<int> cells;
+
+    void resize(int r, int c, int value = 1) {
+        rows = r;
+        cols = c;
+        cells.fill(value, r * c);
+    }
+
+    int *data() { return cells.data(); }
+    MazeView view() const { return MazeView(cells.constData(), rows, cols, cols); }
+};
+
+#endif // MAZEGRID_H
@@ -0,0 +1,79 @@
+#include "mazeio.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+bool loadMazeText(const QString &filePath, MazeGrid &grid, QString *error) {
+    auto fail = [&](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return fail("无法打开文件。"); // 文件无法打开
+
+    QTextStream in(&file);
+    QStringList lines;
+    while (!in.atEnd()) {
+        lines.append(in.readLine().trimmed()); // 读取每行并去除空白字符
+    }
+    file.close();
+
+    if (lines.isEmpty())
+        return fail("文件为空。");
+
+    const int r = lines.size();      // 行数
+    const int c = lines[0].length(); // 列数 (以第一行长度为准)
+
+    // 先解析到临时网格，全部合法后再交给调用方，避免出错时留下一半新一半旧的迷宫
+    MazeGrid parsed;
+    parsed.resize(r, c);
+    for (int i = 0; i < r; ++i) {
+        if (lines[i].length() != c)
+            return fail("文件格式不正确：行长度不一致。");
+        for (int j = 0; j < c; ++j) {
+            QChar ch = lines[i][j];
+            if (ch == '0')
+                parsed.cells[i * c + j] = 0; // '0' 表示通路
+            else if (ch == '1')
+                parsed.cells[i * c + j] = 1; // '1' 表示墙壁
+            else
+                return fail(QString("文件格式不正确：包含非法字符 '%1'。").arg(ch));
+        }
+    }
+
+    grid = std::move(parsed);
+    return true;
+}
+
+bool saveMazeText(const QString &filePath, const MazeView &view, QString *error) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        if (error) *error = "无法写入文件。";
+        return false;
+    }
+
+    QTextStream out(&file);
+    for (int y = 0; y < view.rows; ++y) {
+        QString line(view.cols, '0');
+        for (int x = 0; x < view.cols; ++x)
+            if (!view.isOpen(x, y))
+                line[x] = '1';
+        out << line << '\n';
+    }
+    return true;
+}
+
+bool parseMazeSize(const QString &text, int &rows, int &cols) {
+    const QStringList size = text.split('x');
+    if (size.size() != 2) return false;
+    bool okRows = false, okCols = false;
+    int r = size[0].toInt(&okRows);
+    int c = size[1].toInt(&okCols);
+    if (!okRows || !okCols || r < 3 || c < 3) return false;
+    rows = r % 2 == 0 ? r - 1 : r;
+    cols = c % 2 == 0 ? c - 1 : c;
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef MAZEIO_H
+#define MAZEIO_H
+
+#include "mazegrid.h"
+
+#include <QString>
+
+// 迷宫文本文件格式：每行一个由 '0'（通路）和 '1'（墙壁）组成的字符串，各行长度相同
+
+// 读取迷宫文本文件，失败时返回 false，并在 error 中给出原因
+bool loadMazeText(const QString &filePath, MazeGrid &grid, QString *error = nullptr);
+
+// 把迷宫写成文本文件
+bool saveMazeText(const QString &filePath, const MazeView &view, QString *error = nullptr);
+
+// 解析 "<行数>x<列数>" 形式的迷宫尺寸（如 "101x101"），两者都不得小于 3；
+// 与界面一致，偶数会减一取奇数
+bool parseMazeSize(const QString &text, int &rows, int &cols);
+
+#endif // MAZEIO_H
@@ -0,0 +1,302 @@
+#include "multiagentplanner.h"
+
+#include <algorithm>     // std::push_heap, std::pop_heap
+#include <climits>       // INT_MAX
+#include <unordered_map> // std::unordered_map
+
+namespace {
+
+// 四个移动方向加原地等待
+const int kMoveCount = 5;
+const int kMoveDx[kMoveCount] = {0, 1, 0, -1, 0};
+const int kMoveDy[kMoveCount] = {1, 0, -1, 0, 0};
+
+const int kInitialTableSize = 1024; // 哈希表初始槽位数（2 的幂）
+
+} // namespace
+
+// ---------------- CellTimeTable ----------------
+
+CellTimeTable::CellTimeTable()
+    : entries(kInitialTableSize, Entry{0, -1, 0})
+    , currentStamp(1)
+    , count(0)
+{
+}
+
+void CellTimeTable::clear() {
+    ++currentStamp;
+    if (currentStamp == 0) { // 代号回绕时真正清空一次
+        std::fill(entries.begin(), entries.end(), Entry{0, -1, 0});
+        currentStamp = 1;
+    }
+    count = 0;
+}
+
+size_t CellTimeTable::hashKey(quint64 key) {
+    // splitmix64 混合，使相邻单元格和时刻分散到不同槽位
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+int CellTimeTable::value(int cell, int time) const {
+    const quint64 key = makeKey(cell, time);
+    const size_t mask = entries.size() - 1;
+    for (size_t i = hashKey(key) & mask; ; i = (i + 1) & mask) {
+        const Entry &e = entries[i];
+        if (e.stamp != currentStamp) return -1; // 空槽位，键不存在
+        if (e.key == key) return e.value;
+    }
+}
+
+bool CellTimeTable::insert(int cell, int time, int value) {
+    if ((count + 1) * 2 > static_cast<int>(entries.size()))
+        grow(); // 负载因子保持在 0.5 以下
+
+    const quint64 key = makeKey(cell, time);
+    const size_t mask = entries.size() - 1;
+    for (size_t i = hashKey(key) & mask; ; i = (i + 1) & mask) {
+        Entry &e = entries[i];
+        if (e.stamp != currentStamp) {
+            e = Entry{key, value, currentStamp};
+            ++count;
+            return true;
+        }
+        if (e.key == key) return false;
+    }
+}
+
+void CellTimeTable::grow() {
+    std::vector<Entry> old;
+    old.swap(entries);
+    entries.assign(old.size() * 2, Entry{0, -1, 0});
+    const size_t mask = entries.size() - 1;
+    for (const Entry &e : old) {
+        if (e.stamp != currentStamp) continue;
+        size_t i = hashKey(e.key) & mask;
+        while (entries[i].stamp == currentStamp)
+            i = (i + 1) & mask;
+        entries[i] = e;
+    }
+}
+
+// ---------------- MultiAgentPlanner ----------------
+
+MultiAgentPlanner::MultiAgentPlanner(const MazeView &v)
+    : view(v)
+    , horizonSlack(v.rows + v.cols)
+    , expansionFactor(8)
+{
+}
+
+MultiAgentPlanner::Stats MultiAgentPlanner::plan(const QVector<AgentTask> &agents, QVector<QVector<QPoint>> &paths) {
+    Stats stats;
+    const int cellCount = view.cellCount();
+
+    reservations.clear();
+    parkedFrom.assign(cellCount, INT_MAX);
+    lastReserved.assign(cellCount, -1);
+    distance.assign(cellCount, -1); // 之后每个机器人只重置自己的 BFS 写过的单元格
+    bfsQueue.clear();
+    bfsHead = 0;
+    distanceGoal = -1;
+
+    paths.clear();
+    paths.resize(agents.size());
+
+    for (int i = 0; i < agents.size(); ++i) {
+        const AgentTask &task = agents[i];
+        QVector<QPoint> &path = paths[i];
+        path.clear();
+
+        // 起点或目标不可通行时直接判定失败
+        if (!view.isOpen(task.start) || !view.isOpen(task.goal)) {
+            ++stats.failed;
+            continue;
+        }
+
+        if (planAgent(i, view.index(task.start), view.index(task.goal), path, stats.expansions)) {
+            reservePath(i, path);
+            ++stats.planned;
+            stats.makespan = std::max(stats.makespan, static_cast<int>(path.size()) - 1);
+            stats.sumOfCosts += path.size() - 1;
+        } else {
+            ++stats.failed;
+        }
+    }
+    return stats;
+}
+
+// 从目标出发的 BFS 给出忽略其他机器人时的真实距离，作为时空 A* 的启发值
+// 这里只放入源点，由 distanceTo() 按需推进；只重置上一次 BFS 写过的单元格，不按迷宫大小清空
+void MultiAgentPlanner::startDistances(int goal) {
+    if (goal == distanceGoal) return;
+    for (int cell : bfsQueue)
+        distance[cell] = -1;
+    bfsQueue.clear();
+    bfsHead = 0;
+    distanceGoal = goal;
+    distance[goal] = 0;
+    bfsQueue.push_back(goal);
+}
+
+// BFS 按层推进，距离为 d 的单元格在所有距离小于 d 的单元格出队后都已求出，
+// 因此推进到 cell 已知或队首距离达到 limit 即可停止
+int MultiAgentPlanner::distanceTo(int cell, int limit) {
+    while (distance[cell] < 0 && bfsHead < bfsQueue.size() && distance[bfsQueue[bfsHead]] < limit) {
+        const int current = bfsQueue[bfsHead++];
+        const QPoint p = view.point(current);
+        for (int m = 0; m < 4; ++m) {
+            const int nx = p.x() + kMoveDx[m];
+            const int ny = p.y() + kMoveDy[m];
+            if (!view.isOpen(nx, ny)) continue;
+            const int next = view.index(nx, ny);
+            if (distance[next] != -1) continue;
+            distance[next] = distance[current] + 1;
+            bfsQueue.push_back(next);
+        }
+    }
+    return distance[cell] <= limit ? distance[cell] : -1;
+}
+
+bool MultiAgentPlanner::canMove(int from, int to, int time) const {
+    // 目标单元格在下一时刻已被停靠的机器人占用
+    if (time + 1 >= parkedFrom[to]) return false;
+    // 顶点冲突：下一时刻该单元格已被预约
+    if (reservations.value(to, time + 1) != -1) return false;
+    // 对换冲突：占用 to 的机器人下一时刻恰好移到 from
+    if (from != to) {
+        const int other = reservations.value(to, time);
+        if (other != -1 && reservations.value(from, time + 1) == other) return false;
+    }
+    return true;
+}
+
+bool MultiAgentPlanner::planAgent(int agent, int start, int goal, QVector<QPoint> &path, qint64 &expansions) {
+    Q_UNUSED(agent);
+
+    // 起点在 0 时刻已被占用（例如与其他机器人起点重合或其他机器人停在此处）
+    if (parkedFrom[start] <= 0 || reservations.value(start, 0) != -1) return false;
+    // 目标已被其他机器人永久占用
+    if (parkedFrom[goal] != INT_MAX) return false;
+
+    startDistances(goal);
+    const int startDistance = distanceTo(start, INT_MAX); // BFS 推进到起点为止
+    if (startDistance < 0) return false; // 静态迷宫中就不可达
+
+    const int horizon = startDistance + horizonSlack;
+    const qint64 expansionLimit = static_cast<qint64>(expansionFactor) * (horizon + 1);
+    qint64 expanded = 0;
+
+    nodes.clear();
+    open.clear();
+    visited.clear();
+
+    nodes.push_back(StateNode{start, 0, -1});
+    visited.insert(start, 0, 0);
+    open.push_back(OpenEntry{startDistance, 0, 0});
+
+    int goalNode = -1;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end());
+        const OpenEntry top = open.back();
+        open.pop_back();
+        ++expansions;
+        if (++expanded > expansionLimit) break; // 超出扩展预算，判定失败
+
+        const StateNode current = nodes[top.node];
+        // 到达目标且此后不会再有其他机器人经过目标，才能在目标停靠
+        if (current.cell == goal && current.time > lastReserved[goal]) {
+            goalNode = top.node;
+            break;
+        }
+
+        const QPoint p = view.point(current.cell);
+        for (int m = 0; m < kMoveCount; ++m) {
+            const int nx = p.x() + kMoveDx[m];
+            const int ny = p.y() + kMoveDy[m];
+            if (!view.isOpen(nx, ny)) continue;
+            const int next = view.index(nx, ny);
+            const int nextTime = current.time + 1;
+            // 只需知道距离是否在剩余时间内，BFS 不必推进到更远处
+            const int h = distanceTo(next, horizon - nextTime);
+            if (h < 0) continue;
+            if (!canMove(current.cell, next, current.time)) continue;
+            // 代价都为 1，g 等于时刻，因此同一时空状态第一次生成时即为最优
+            if (!visited.insert(next, nextTime, static_cast<int>(nodes.size()))) continue;
+
+            nodes.push_back(StateNode{next, nextTime, top.node});
+            open.push_back(OpenEntry{nextTime + h, nextTime, static_cast<int>(nodes.size()) - 1});
+            std::push_heap(open.begin(), open.end());
+        }
+    }
+
+    if (goalNode < 0) return false;
+
+    // 节点的时刻即为其在路径中的下标，直接按下标回填，无需反转
+    path.resize(nodes[goalNode].time + 1);
+    for (int n = goalNode; n != -1; n = nodes[n].parent)
+        path[nodes[n].time] = view.point(nodes[n].cell);
+    return true;
+}
+
+void MultiAgentPlanner::reservePath(int agent, const QVector<QPoint> &path) {
+    for (int t = 0; t < path.size(); ++t) {
+        const int cell = view.index(path[t]);
+        reservations.insert(cell, t, agent);
+        lastReserved[cell] = std::max(lastReserved[cell], t);
+    }
+    parkedFrom[view.index(path.last())] = static_cast<int>(path.size()) - 1;
+}
+
+bool MultiAgentPlanner::findFirstConflict(const QVector<QVector<QPoint>> &paths, Conflict &conflict) {
+    int makespan = 0;
+    for (const QVector<QPoint> &p : paths)
+        makespan = std::max(makespan, static_cast<int>(p.size()));
+
+    // 到达终点后停留在最后一个位置
+    auto positionAt = [&](int agent, int t) {
+        const QVector<QPoint> &p = paths[agent];
+        return p[std::min(t, static_cast<int>(p.size()) - 1)];
+    };
+    auto key = [](const QPoint &p) {
+        return (static_cast<quint64>(static_cast<quint32>(p.y())) << 32) | static_cast<quint32>(p.x());
+    };
+
+    std::unordered_map<quint64, int> occupied; // 当前时刻：位置 -> 机器人
+    std::unordered_map<quint64, int> previous; // 上一时刻：位置 -> 机器人
+    for (int t = 0; t < makespan; ++t) {
+        occupied.clear();
+        for (int a = 0; a < paths.size(); ++a) {
+            if (paths[a].isEmpty()) continue;
+            const QPoint pos = positionAt(a, t);
+            auto inserted = occupied.emplace(key(pos), a);
+            if (!inserted.second) {
+                conflict = Conflict{inserted.first->second, a, t, pos, false};
+                return true;
+            }
+        }
+        if (t > 0) {
+            for (int a = 0; a < paths.size(); ++a) {
+                if (paths[a].isEmpty()) continue;
+                const QPoint from = positionAt(a, t - 1);
+                const QPoint to = positionAt(a, t);
+                if (from == to) continue;
+                // 上一时刻在 to 的机器人，这一时刻是否移到了 from
+                auto it = previous.find(key(to));
+                if (it == previous.end() || it->second == a) continue;
+                const int b = it->second;
+                if (positionAt(b, t) == from) {
+                    conflict = Conflict{a, b, t, to, true};
+                    return true;
+                }
+            }
+        }
+        previous.swap(occupied);
+    }
+    return false;
+}
@@ -0,0 +1,138 @@
+#ifndef MULTIAGENTPLANNER_H
+#define MULTIAGENTPLANNER_H
+
+#include "mazegrid.h"
+
+#include <QPoint>
+#include <QVector>
+
+#include <vector>
+
+// (单元格, 时刻) -> 整数 的开放寻址哈希表
+// 用作多机器人规划中的时空预约表，也用作单次时空搜索的已访问集合。
+// clear() 只递增代号而不清空内存，因此在多次搜索之间反复使用时没有重新分配的开销。
+class CellTimeTable
+{
+public:
+    CellTimeTable();
+
+    void clear();                                 // O(1) 清空
+    int value(int cell, int time) const;          // 查找，不存在时返回 -1
+    bool insert(int cell, int time, int value);   // 插入，键已存在时不覆盖并返回 false
+    int size() const { return count; }
+
+private:
+    struct Entry {
+        quint64 key;
+        int value;
+        quint32 stamp; // 与 currentStamp 相同才表示该槽位有效
+    };
+
+    std::vector<Entry> entries;
+    quint32 currentStamp;
+    int count;
+
+    static quint64 makeKey(int cell, int time) {
+        return (static_cast<quint64>(static_cast<quint32>(time)) << 32) | static_cast<quint32>(cell);
+    }
+    static size_t hashKey(quint64 key);
+    void grow();
+};
+
+// 单个机器人的规划任务
+struct AgentTask {
+    QPoint start; // 起点
+    QPoint goal;  // 目标点
+};
+
+// 多机器人协同寻路（优先级时空 A*）
+// 按任务顺序（即优先级）逐个为机器人规划路径：每个机器人在 (单元格, 时刻) 状态空间中做 A* 搜索，
+// 动作为上下左右移动或原地等待，代价均为 1；启发值为忽略其他机器人时到目标的真实距离，
+// 由从目标出发的 BFS 按需推进求出：只推进到搜索实际查询的距离为止，不遍历整个迷宫，
+// 相邻机器人目标相同时沿用上一次的 BFS 结果。
+// 规划总是按 4 邻域进行，不使用 SolverOptions::neighborhood：斜向移动的代价不为 1（时刻与代价不再一致），
+// 而且两个机器人在同一个 2x2 方格内交叉斜行也需要额外的冲突检测。
+// 已规划的路径写入时空预约表，后续机器人不能占用相同的 (单元格, 时刻)，也不能与之对换位置；
+// 到达目标的机器人此后一直停在目标上。
+// 搜索用的节点池、开放列表、距离表等缓冲区在各个机器人之间复用。
+// findFirstConflict() 给出一组路径中的第一个冲突，是今后实现基于冲突的搜索（CBS）的基础。
+class MultiAgentPlanner
+{
+public:
+    // 规划统计信息
+    struct Stats {
+        int planned = 0;         // 成功规划的机器人数量
+        int failed = 0;          // 规划失败的机器人数量
+        qint64 expansions = 0;   // 扩展的时空状态总数
+        int makespan = 0;        // 所有路径中最晚的到达时刻
+        qint64 sumOfCosts = 0;   // 各机器人到达时刻之和
+    };
+
+    // 两条路径之间的冲突
+    struct Conflict {
+        int agentA = -1;
+        int agentB = -1;
+        int time = 0;       // 发生冲突的时刻
+        QPoint cell;        // 顶点冲突的位置；对换冲突时为 agentA 在该时刻的位置
+        bool swap = false;  // true 表示对换冲突（相向穿过同一条边）
+    };
+
+    explicit MultiAgentPlanner(const MazeView &view);
+
+    // 时间上限 = 起点到目标的距离 + horizonSlack，超过上限的状态不再扩展
+    void setHorizonSlack(int slack) { horizonSlack = slack; }
+    // 每个机器人最多扩展 expansionFactor * (时间上限 + 1) 个状态，超出即判定失败，
+    // 避免被堵死的机器人穷举整个时空状态空间
+    void setExpansionFactor(int factor) { expansionFactor = factor; }
+
+    // 为所有机器人规划路径，paths[i][t] 为第 i 个机器人在 t 时刻的位置（到达后停留在最后一个位置）
+    // 规划失败的机器人得到空路径，视为不在场，不参与后续机器人的避让
+    Stats plan(const QVector<AgentTask> &agents, QVector<QVector<QPoint>> &paths);
+
+    // 查找一组路径中最早发生的顶点冲突或对换冲突，没有冲突时返回 false
+    static bool findFirstConflict(const QVector<QVector<QPoint>> &paths, Conflict &conflict);
+
+private:
+    // 时空搜索节点
+    struct StateNode {
+        int cell;
+        int time;
+        int parent; // 父节点在节点池中的下标，-1 表示起点
+    };
+
+    // 开放列表元素：按 f 从小到大，f 相同时优先时刻更晚（更接近目标）的节点
+    struct OpenEntry {
+        int f;
+        int time;
+        int node;
+        bool operator<(const OpenEntry &o) const {
+            if (f != o.f) return f > o.f;
+            return time < o.time;
+        }
+    };
+
+    MazeView view;
+    int horizonSlack;
+    int expansionFactor;
+
+    CellTimeTable reservations;   // 时空预约表：(单元格, 时刻) -> 机器人编号
+    std::vector<int> parkedFrom;  // 每个单元格被到达目标的机器人永久占用的起始时刻
+    std::vector<int> lastReserved;// 每个单元格最后一次被预约的时刻
+
+    // 以下缓冲区在各个机器人之间复用
+    std::vector<int> distance;    // 到当前目标的 BFS 距离，-1 表示尚未求出（可能不可达）
+    std::vector<int> bfsQueue;    // BFS 队列，也是 distance 中被写过的全部单元格
+    size_t bfsHead = 0;           // 下一个出队的下标
+    int distanceGoal = -1;        // 当前 BFS 的目标
+    std::vector<StateNode> nodes;
+    std::vector<OpenEntry> open;
+    CellTimeTable visited;        // 已生成的时空状态
+
+    void startDistances(int goal);          // 以 goal 为源开始新的 BFS（目标不变时沿用）
+    int distanceTo(int cell, int limit);    // 到目标的距离；超过 limit 或不可达时返回 -1
+    bool canMove(int from, int to, int time) const; // 能否在 time -> time + 1 从 from 移到 to
+    bool planAgent(int agent, int start, int goal, QVector<QPoint> &path, qint64 &expansions);
+    void reservePath(int agent, const QVector<QPoint> &path);
+};
+
+#endif // MULTIAGENTPLANNER_H
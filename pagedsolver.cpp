@@ -0,0 +1,33 @@
+#include "pagedsolver.h"
+
+// 根据启发函数类型选择实例（邻域已确定）
+template <class N>
+static bool dispatchTiledHeuristic(TiledGrid &grid, const QPoint &start, const QPoint &goal,
+                                   HeuristicKind heuristic, PagedWorkspace &ws, CompactPath &path)
+{
+    switch (heuristic) {
+    case HeuristicKind::Manhattan:
+        return solveTiled<N, ManhattanHeuristic>(grid, start, goal, ws, path);
+    case HeuristicKind::Octile:
+        return solveTiled<N, OctileHeuristic>(grid, start, goal, ws, path);
+    case HeuristicKind::Zero:
+        return solveTiled<N, ZeroHeuristic>(grid, start, goal, ws, path);
+    }
+    return false;
+}
+
+bool findPathTiled(TiledGrid &grid, const QPoint &start, const QPoint &goal,
+                   const SolverOptions &options, PagedWorkspace &ws, CompactPath &path)
+{
+    ws.reset();
+    if (!grid.isOpen(start) || !grid.isOpen(goal))
+        return false;
+
+    switch (options.neighborhood) {
+    case Neighborhood::Four:
+        return dispatchTiledHeuristic<FourConnected>(grid, start, goal, options.heuristic, ws, path);
+    case Neighborhood::Eight:
+        return dispatchTiledHeuristic<EightConnected>(grid, start, goal, options.heuristic, ws, path);
+    }
+    return false;
+}
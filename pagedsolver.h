@@ -0,0 +1,179 @@
+#ifndef PAGEDSOLVER_H
+#define PAGEDSOLVER_H
+
+#include "compactpath.h"
+#include "pathsolver.h"
+#include "tiledgrid.h"
+
+#include <QPoint>
+
+#include <algorithm>     // std::push_heap, std::pop_heap
+#include <cstdlib>       // std::abs
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+// 分块网格上的 A* 搜索
+// 地图本身通过 TiledGrid 按块换入换出；搜索状态只为访问过的单元格分配（哈希表），
+// 不像 SolverWorkspace 那样按整个地图的单元格数分配数组，因此内存只与搜索范围有关。
+// 开放列表在 f 相同时按所在块的 Morton（Z 序）编号排序，同一 f 层内先把一块扩展完再换下一块；
+// 相邻两层按相反方向扫描（蛇形），下一层从上一层最后用到、仍在缓存中的块开始，
+// 避免搜索前沿跨越的块数超过缓存容量时 LRU 每层都把整个前沿换出一遍。
+// f 仍是第一关键字，不影响结果的最优性。
+struct PagedWorkspace {
+    struct Node {
+        qint64 parent; // 父单元格编号（y * cols + x），-1 表示起点
+        qint64 g;      // 起点到该单元格的最小代价
+        bool closed;   // 已出队扩展
+    };
+    std::unordered_map<qint64, Node> nodes;
+
+    // 开放列表元素：f 小者优先，其次按块的扫描顺序（见 tileKey），最后 g 大者（更接近终点）优先
+    struct OpenEntry {
+        qint64 f;
+        quint64 tileKey;
+        qint64 g;
+        qint64 cell;
+        bool operator<(const OpenEntry &o) const {
+            if (f != o.f) return f > o.f;
+            if (tileKey != o.tileKey) return tileKey > o.tileKey;
+            return g < o.g;
+        }
+    };
+    std::vector<OpenEntry> open;
+
+    qint64 nodeLimit = 0;  // 哈希表结点数与开放列表元素数之和的上限，0 表示不限制
+    qint64 expanded = 0;   // 最近一次搜索扩展的单元格数
+    bool limited = false;  // 最近一次搜索因达到 nodeLimit 而放弃
+
+    void reset() {
+        nodes.clear();
+        open.clear();
+        expanded = 0;
+        limited = false;
+    }
+
+    // 哈希表每个结点的估计字节数：键值对加上单链表指针（桶数组另计）
+    static const qint64 kNodeBytes = sizeof(std::unordered_map<qint64, Node>::value_type) + sizeof(void *);
+
+    // 搜索状态当前占用的估计字节数：哈希表结点和桶数组，加上开放列表已分配的容量
+    qint64 stateBytes() const {
+        return static_cast<qint64>(nodes.size()) * kNodeBytes
+             + static_cast<qint64>(nodes.bucket_count() * sizeof(void *))
+             + static_cast<qint64>(open.capacity() * sizeof(OpenEntry));
+    }
+
+    // 给定内存预算时的 nodeLimit：每计入上限的一项最多占用
+    // 一个哈希表结点加一个桶指针（装载因子不超过 1），或两个开放列表元素（vector 扩容时容量最多翻倍）
+    static qint64 nodeLimitFor(qint64 budgetBytes) {
+        const qint64 perEntry = qMax<qint64>(kNodeBytes + sizeof(void *), 2 * sizeof(OpenEntry));
+        return qMax<qint64>(1, budgetBytes / perEntry);
+    }
+
+    // f 层内块的扫描顺序：块坐标的 Morton 编码（交错 tx、ty 的各位），
+    // 以两步直行代价为一层，相邻层取反，使扫描方向交替
+    static quint64 tileKey(qint64 f, int tx, int ty) {
+        const quint64 key = mortonKey(tx, ty);
+        return ((f / (2 * kStraightCost)) & 1) ? ~key : key;
+    }
+
+    static quint64 mortonKey(int tx, int ty) {
+        auto spread = [](quint64 v) {
+            v &= 0xFFFFFFFFULL;
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            v = (v | (v << 2)) & 0x3333333333333333ULL;
+            v = (v | (v << 1)) & 0x5555555555555555ULL;
+            return v;
+        };
+        return spread(static_cast<quint64>(tx)) | (spread(static_cast<quint64>(ty)) << 1);
+    }
+};
+
+// 分块网格上的 A* 主循环，邻域和启发函数与 searchGrid 相同；找到时回溯出 path
+template <class N, class H>
+bool solveTiled(TiledGrid &grid, const QPoint &start, const QPoint &goal, PagedWorkspace &ws, CompactPath &path)
+{
+    const qint64 cols = grid.cols();
+    const int edge = grid.tileSize();
+    const qint64 startCell = start.y() * cols + start.x();
+    const qint64 goalCell = goal.y() * cols + goal.x();
+    auto estimate = [&](int x, int y) {
+        return static_cast<qint64>(H::estimate(std::abs(x - goal.x()), std::abs(y - goal.y())));
+    };
+    auto push = [&](qint64 cell, int x, int y, qint64 g) {
+        const qint64 f = g + estimate(x, y);
+        ws.open.push_back({f, PagedWorkspace::tileKey(f, x / edge, y / edge), g, cell});
+        std::push_heap(ws.open.begin(), ws.open.end());
+    };
+
+    ws.reset();
+    ws.nodes[startCell] = {-1, 0, false};
+    push(startCell, start.x(), start.y(), 0);
+
+    bool found = false;
+    while (!ws.open.empty()) {
+        std::pop_heap(ws.open.begin(), ws.open.end());
+        const PagedWorkspace::OpenEntry top = ws.open.back();
+        ws.open.pop_back();
+
+        // 懒删除：同一单元格可能以不同代价多次入队，只处理第一次出队
+        PagedWorkspace::Node &node = ws.nodes[top.cell];
+        if (node.closed) continue;
+        node.closed = true;
+        ++ws.expanded;
+
+        if (top.cell == goalCell) {
+            found = true;
+            break;
+        }
+
+        const int x = static_cast<int>(top.cell % cols);
+        const int y = static_cast<int>(top.cell / cols);
+        for (int k = 0; k < N::kCount; ++k) {
+            const int nx = x + N::dx[k];
+            const int ny = y + N::dy[k];
+            // 先查墙壁：相邻单元格大多与当前单元格在同一块内，走 isOpen 的快速路径
+            if (!grid.isOpen(nx, ny)) continue;
+            // 墙角规则同 EightConnected::cornerClear
+            if (k >= 4 && (!grid.isOpen(nx, y) || !grid.isOpen(x, ny))) continue;
+
+            const qint64 next = ny * cols + nx;
+            const qint64 tentative = top.g + N::cost[k];
+            auto it = ws.nodes.find(next);
+            if (it != ws.nodes.end() && (it->second.closed || tentative >= it->second.g)) continue;
+            // 每次入队都会新增一个开放列表元素（懒删除不会收回旧元素），它和哈希表结点一起计入上限
+            if (ws.nodeLimit > 0 && static_cast<qint64>(ws.nodes.size() + ws.open.size()) >= ws.nodeLimit) {
+                ws.limited = true;
+                return false;
+            }
+            if (it != ws.nodes.end()) {
+                it->second.g = tentative;
+                it->second.parent = top.cell;
+            } else {
+                ws.nodes.emplace(next, PagedWorkspace::Node{top.cell, tentative, false});
+            }
+            push(next, nx, ny, tentative);
+        }
+    }
+    if (!found)
+        return false;
+
+    // 从终点沿父指针回溯：先数出步数，再按下标从后往前写入方向编码
+    int steps = 0;
+    for (qint64 c = goalCell; ws.nodes[c].parent != -1; c = ws.nodes[c].parent) ++steps;
+    path = CompactPath(start, steps, N::kCount == 4 ? 2 : 3);
+    for (qint64 c = goalCell; ws.nodes[c].parent != -1; ) {
+        const qint64 p = ws.nodes[c].parent;
+        path.setStep(--steps, CompactPath::directionCode(static_cast<int>(c % cols - p % cols),
+                                                         static_cast<int>(c / cols - p / cols)));
+        c = p;
+    }
+    return true;
+}
+
+// 分块网格上的寻路，按选项分派到对应的模板实例
+bool findPathTiled(TiledGrid &grid, const QPoint &start, const QPoint &goal,
+                   const SolverOptions &options, PagedWorkspace &ws, CompactPath &path);
+
+#endif // PAGEDSOLVER_H
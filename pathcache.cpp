@@ -0,0 +1,169 @@
+#include "pathcache.h"
+
+namespace {
+
+// splitmix64 混合函数
+quint64 mix64(quint64 x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+int optionsCode(const SolverOptions &options) {
+    return static_cast<int>(options.neighborhood) * 16 + static_cast<int>(options.heuristic);
+}
+
+} // namespace
+
+PathCache::PathCache(int cap, int treeCap)
+    : capacity(cap)
+    , treeCapacity(treeCap)
+{
+}
+
+quint64 PathCache::cellHash(int index) {
+    return mix64(static_cast<quint64>(index) + 1);
+}
+
+quint64 PathCache::hashMaze(const MazeView &view) {
+    // 尺寸参与哈希，墙壁单元格逐个异或，便于编辑时增量更新
+    quint64 h = mix64((static_cast<quint64>(view.rows) << 32) ^ static_cast<quint64>(view.cols) ^ 0xA5A5A5A5ULL);
+    for (int y = 0; y < view.rows; ++y)
+        for (int x = 0; x < view.cols; ++x)
+            if (!view.isOpen(x, y))
+                h ^= cellHash(view.index(x, y));
+    return h;
+}
+
+size_t PathCache::KeyHash::operator()(const Key &k) const {
+    quint64 h = mix64(k.maze);
+    h = mix64(h ^ ((static_cast<quint64>(static_cast<quint32>(k.sx)) << 32) | static_cast<quint32>(k.sy)));
+    h = mix64(h ^ ((static_cast<quint64>(static_cast<quint32>(k.gx)) << 32) | static_cast<quint32>(k.gy)));
+    return static_cast<size_t>(h ^ static_cast<quint64>(k.options));
+}
+
+void PathCache::setMazeHash(quint64 hash) {
+    if (hash == currentMaze) return;
+    clear();
+    currentMaze = hash;
+}
+
+void PathCache::clear() {
+    entries.clear();
+    index.clear();
+    trees.clear();
+    hasLast = false;
+}
+
+PathCache::GoalTree *PathCache::findTree(const QPoint &goal, Neighborhood neighborhood) {
+    for (auto it = trees.begin(); it != trees.end(); ++it) {
+        if (it->goal == goal && it->neighborhood == neighborhood) {
+            trees.splice(trees.begin(), trees, it); // 移到表头
+            return &trees.front();
+        }
+    }
+    return nullptr;
+}
+
+// 沿最短路径树从起点走到根，按顺序写入方向编码
+bool PathCache::walkTree(const MazeView &view, const GoalTree &tree, const QPoint &start, CompactPath &path) {
+    const int startCell = view.index(start);
+    if (tree.next[startCell] == -2) return false; // 与终点不连通
+
+    int steps = 0;
+    for (int c = startCell; tree.next[c] != -1; c = tree.next[c]) ++steps;
+
+    path = CompactPath(start, steps, tree.neighborhood == Neighborhood::Four ? 2 : 3);
+    int i = 0;
+    for (int c = startCell; tree.next[c] != -1; c = tree.next[c]) {
+        const int n = tree.next[c];
+        path.setStep(i++, CompactPath::directionCode(n % view.stride - c % view.stride, n / view.stride - c / view.stride));
+    }
+    return true;
+}
+
+void PathCache::remember(const Key &key, bool found, const CompactPath &path) {
+    entries.push_front(Entry{key, found, path});
+    index[key] = entries.begin();
+    while (static_cast<int>(entries.size()) > capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+bool PathCache::lookup(const QPoint &start, const QPoint &goal, const SolverOptions &options,
+                       bool &found, CompactPath &path) {
+    const Key key{currentMaze, start.x(), start.y(), goal.x(), goal.y(), optionsCode(options)};
+    auto hit = index.find(key);
+    if (hit == index.end()) {
+        ++counters.misses;
+        source = Source::Miss;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, hit->second); // 移到表头
+    ++counters.hits;
+    source = Source::Hit;
+    found = entries.front().found;
+    path = entries.front().path;
+    return true;
+}
+
+void PathCache::store(const QPoint &start, const QPoint &goal, const SolverOptions &options,
+                      bool found, const CompactPath &path) {
+    const Key key{currentMaze, start.x(), start.y(), goal.x(), goal.y(), optionsCode(options)};
+    if (index.count(key)) return; // 其他线程已经存入
+    remember(key, found, found ? path : CompactPath());
+}
+
+bool PathCache::solve(const MazeView &view, const QPoint &start, const QPoint &goal,
+                      const SolverOptions &options, SolverWorkspace &ws, CompactPath &path) {
+    const Key key{currentMaze, start.x(), start.y(), goal.x(), goal.y(), optionsCode(options)};
+    const bool onlyStartMoved = hasLast && lastKey.maze == key.maze && lastKey.gx == key.gx
+            && lastKey.gy == key.gy && lastKey.options == key.options
+            && (lastKey.sx != key.sx || lastKey.sy != key.sy);
+    lastKey = key;
+    hasLast = true;
+
+    // 1. 完全相同的查询
+    auto hit = index.find(key);
+    if (hit != index.end()) {
+        entries.splice(entries.begin(), entries, hit->second); // 移到表头
+        ++counters.hits;
+        source = Source::Hit;
+        path = entries.front().path;
+        return entries.front().found;
+    }
+
+    // 2. 终点已有最短路径树；或者只移动了起点，此时为终点构建一棵树
+    if (view.isOpen(start) && view.isOpen(goal)) {
+        GoalTree *tree = findTree(goal, options.neighborhood);
+        if (!tree && onlyStartMoved) {
+            trees.push_front(GoalTree{goal, options.neighborhood, {}});
+            buildShortestPathTree(view, goal, options.neighborhood, ws, trees.front().next);
+            while (static_cast<int>(trees.size()) > treeCapacity)
+                trees.pop_back();
+            tree = &trees.front();
+            ++counters.misses; // 构建树本身需要一次完整搜索，不计为命中
+            source = Source::Miss;
+            bool found = walkTree(view, *tree, start, path);
+            remember(key, found, path);
+            return found;
+        }
+        if (tree) {
+            ++counters.treeHits;
+            source = Source::TreeHit;
+            bool found = walkTree(view, *tree, start, path);
+            remember(key, found, path);
+            return found;
+        }
+    }
+
+    // 3. 未命中，重新搜索
+    ++counters.misses;
+    source = Source::Miss;
+    bool found = findPath(view, start, goal, options, ws, path);
+    if (!found) path.clear();
+    remember(key, found, path);
+    return found;
+}
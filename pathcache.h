@@ -0,0 +1,107 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "compactpath.h"
+#include "mazegrid.h"
+#include "pathsolver.h"
+
+#include <QPoint>
+
+#include <list>          // std::list
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+// 寻路结果缓存（LRU）
+// 以 (迷宫内容哈希, 起点, 终点, 寻路选项) 为键缓存寻路结果（包括“不可达”）。
+// 迷宫内容哈希按墙壁单元格做异或累积：生成/加载迷宫后用 hashMaze() 重新计算，
+// 编辑单个单元格时用 cellHash() 增量更新，哈希变化时缓存自动失效。
+// 如果连续两次查询终点相同而只有起点改变，则从终点构建一棵最短路径树并缓存，
+// 此后起点再怎么移动，都只需沿树走一遍即可得到路径，不必重新搜索。
+class PathCache
+{
+public:
+    // 最近一次查询的结果来源
+    enum class Source { Miss, Hit, TreeHit };
+
+    // 命中统计
+    struct Stats {
+        qint64 hits = 0;     // 直接命中缓存的查询数
+        qint64 treeHits = 0; // 由最短路径树得到结果的查询数
+        qint64 misses = 0;   // 需要重新搜索的查询数
+        qint64 queries() const { return hits + treeHits + misses; }
+        double hitRate() const { return queries() ? double(hits + treeHits) / queries() : 0.0; }
+    };
+
+    explicit PathCache(int capacity = 256, int treeCapacity = 4);
+
+    // 迷宫内容哈希
+    static quint64 hashMaze(const MazeView &view);
+    // 单元格 index 在墙壁和通路之间切换时，迷宫哈希异或上这个值
+    static quint64 cellHash(int index);
+
+    // 设置当前迷宫的哈希，与原来不同时清空所有缓存
+    void setMazeHash(quint64 hash);
+    quint64 mazeHash() const { return currentMaze; }
+
+    // 带缓存的寻路：先查缓存，再查最短路径树，最后才调用 findPath
+    // options 应已经过 admissibleOptions，A* 找到的都是最短路径，与最短路径树的结果等价
+    bool solve(const MazeView &view, const QPoint &start, const QPoint &goal,
+               const SolverOptions &options, SolverWorkspace &ws, CompactPath &path);
+
+    // 只查、只存完全相同的查询（不使用最短路径树，也不搜索），
+    // 供多个线程共享一个缓存时使用：调用方在锁内查找，在锁外搜索，再在锁内存入
+    bool lookup(const QPoint &start, const QPoint &goal, const SolverOptions &options,
+                bool &found, CompactPath &path);
+    void store(const QPoint &start, const QPoint &goal, const SolverOptions &options,
+               bool found, const CompactPath &path);
+
+    Source lastSource() const { return source; }
+    const Stats &stats() const { return counters; }
+    void clear();
+
+private:
+    struct Key {
+        quint64 maze;
+        int sx, sy, gx, gy;
+        int options; // 邻域和启发函数的组合编号
+        bool operator==(const Key &o) const {
+            return maze == o.maze && sx == o.sx && sy == o.sy && gx == o.gx && gy == o.gy && options == o.options;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &k) const;
+    };
+    struct Entry {
+        Key key;
+        bool found;
+        CompactPath path;
+    };
+
+    // 以终点为根的最短路径树
+    struct GoalTree {
+        QPoint goal;
+        Neighborhood neighborhood;
+        std::vector<int> next; // 见 buildPathTree()
+    };
+
+    int capacity;
+    int treeCapacity;
+    quint64 currentMaze = 0;
+
+    std::list<Entry> entries; // 表头为最近使用
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::list<GoalTree> trees; // 表头为最近使用
+
+    // 上一次查询，用于判断是否“只移动了起点”
+    bool hasLast = false;
+    Key lastKey {};
+
+    Source source = Source::Miss;
+    Stats counters;
+
+    GoalTree *findTree(const QPoint &goal, Neighborhood neighborhood);
+    static bool walkTree(const MazeView &view, const GoalTree &tree, const QPoint &start, CompactPath &path);
+    void remember(const Key &key, bool found, const CompactPath &path);
+};
+
+#endif // PATHCACHE_H
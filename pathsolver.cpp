@@ -0,0 +1,159 @@
+#include "pathsolver.h"
+
+bool parseNeighborhood(const QString &text, Neighborhood &neighborhood)
+{
+    if (text == "4") {
+        neighborhood = Neighborhood::Four;
+        return true;
+    }
+    if (text == "8") {
+        neighborhood = Neighborhood::Eight;
+        return true;
+    }
+    return false;
+}
+
+bool parseHeuristic(const QString &text, HeuristicKind &heuristic)
+{
+    const QString t = text.toLower();
+    if (t == "manhattan") {
+        heuristic = HeuristicKind::Manhattan;
+        return true;
+    }
+    if (t == "octile") {
+        heuristic = HeuristicKind::Octile;
+        return true;
+    }
+    if (t == "zero" || t == "dijkstra") {
+        heuristic = HeuristicKind::Zero;
+        return true;
+    }
+    return false;
+}
+
+QString heuristicName(HeuristicKind heuristic)
+{
+    switch (heuristic) {
+    case HeuristicKind::Manhattan: return "manhattan";
+    case HeuristicKind::Octile: return "octile";
+    case HeuristicKind::Zero: return "zero";
+    }
+    return QString();
+}
+
+SolverOptions admissibleOptions(SolverOptions options)
+{
+    if (options.neighborhood == Neighborhood::Eight && options.heuristic == HeuristicKind::Manhattan)
+        options.heuristic = HeuristicKind::Octile;
+    return options;
+}
+
+// 根据启发函数类型选择实例（邻域已确定）
+template <class N>
+static bool dispatchHeuristic(const MazeView &view, const QPoint &start, const QPoint &goal,
+                              HeuristicKind heuristic, SolverWorkspace &ws, CompactPath &path,
+                              const QVector<QPoint> &blocked)
+{
+    switch (heuristic) {
+    case HeuristicKind::Manhattan:
+        return solveGrid<N, ManhattanHeuristic>(view, start, goal, ws, path, blocked);
+    case HeuristicKind::Octile:
+        return solveGrid<N, OctileHeuristic>(view, start, goal, ws, path, blocked);
+    case HeuristicKind::Zero:
+        return solveGrid<N, ZeroHeuristic>(view, start, goal, ws, path, blocked);
+    }
+    return false;
+}
+
+int pathCost(const CompactPath &path)
+{
+    int cost = 0;
+    for (int i = 0; i < path.steps(); ++i)
+        cost += path.step(i) < 4 ? kStraightCost : kDiagonalCost;
+    return cost;
+}
+
+bool findPath(const MazeView &view, const QPoint &start, const QPoint &goal,
+              const SolverOptions &options, SolverWorkspace &ws, CompactPath &path,
+              const QVector<QPoint> &blocked)
+{
+    if (!view.isOpen(start) || !view.isOpen(goal))
+        return false;
+
+    switch (options.neighborhood) {
+    case Neighborhood::Four:
+        return dispatchHeuristic<FourConnected>(view, start, goal, options.heuristic, ws, path, blocked);
+    case Neighborhood::Eight:
+        return dispatchHeuristic<EightConnected>(view, start, goal, options.heuristic, ws, path, blocked);
+    }
+    return false;
+}
+
+// 多目标搜索并回溯路径
+template <class N, class H>
+static bool solveNearest(const MazeView &view, const QVector<QPoint> &sources, const GoalSet &goals,
+                         SolverWorkspace &ws, CompactPath &path, NearestResult *result)
+{
+    const int stride = view.stride;
+    const int goalCell = searchNearest<N, H>(view, sources, goals, ws);
+    if (goalCell < 0)
+        return false;
+
+    int steps = 0;
+    int startCell = goalCell;
+    for (; ws.parent[startCell] != -1; startCell = ws.parent[startCell]) ++steps;
+    path = CompactPath(view.point(startCell), steps, N::kCount == 4 ? 2 : 3);
+    for (int c = goalCell; ws.parent[c] != -1; c = ws.parent[c]) {
+        const int p = ws.parent[c];
+        path.setStep(--steps, CompactPath::directionCode(c % stride - p % stride, c / stride - p / stride));
+    }
+
+    if (result) {
+        result->source = static_cast<int>(sources.indexOf(view.point(startCell)));
+        result->goal = goals.goalAt(goalCell % stride, goalCell / stride);
+        result->cost = ws.g[goalCell];
+    }
+    return true;
+}
+
+template <class N>
+static bool dispatchNearestHeuristic(const MazeView &view, const QVector<QPoint> &sources, const GoalSet &goals,
+                                     HeuristicKind heuristic, SolverWorkspace &ws, CompactPath &path,
+                                     NearestResult *result)
+{
+    switch (heuristic) {
+    case HeuristicKind::Manhattan:
+        return solveNearest<N, ManhattanHeuristic>(view, sources, goals, ws, path, result);
+    case HeuristicKind::Octile:
+        return solveNearest<N, OctileHeuristic>(view, sources, goals, ws, path, result);
+    case HeuristicKind::Zero:
+        return solveNearest<N, ZeroHeuristic>(view, sources, goals, ws, path, result);
+    }
+    return false;
+}
+
+bool findNearest(const MazeView &view, const QVector<QPoint> &sources, const GoalSet &goals,
+                 const SolverOptions &options, SolverWorkspace &ws, CompactPath &path,
+                 NearestResult *result)
+{
+    switch (options.neighborhood) {
+    case Neighborhood::Four:
+        return dispatchNearestHeuristic<FourConnected>(view, sources, goals, options.heuristic, ws, path, result);
+    case Neighborhood::Eight:
+        return dispatchNearestHeuristic<EightConnected>(view, sources, goals, options.heuristic, ws, path, result);
+    }
+    return false;
+}
+
+void buildShortestPathTree(const MazeView &view, const QPoint &root, Neighborhood neighborhood,
+                           SolverWorkspace &ws, std::vector<int> &next)
+{
+    switch (neighborhood) {
+    case Neighborhood::Four:
+        buildPathTree<FourConnected>(view, root, ws, next);
+        break;
+    case Neighborhood::Eight:
+        buildPathTree<EightConnected>(view, root, ws, next);
+        break;
+    }
+}
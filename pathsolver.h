@@ -0,0 +1,343 @@
+#ifndef PATHSOLVER_H
+#define PATHSOLVER_H
+
+#include "compactpath.h"
+#include "goalset.h"
+#include "mazegrid.h"
+
+#include <QPoint>
+#include <QString>
+#include <QVector>
+
+#include <algorithm> // std::push_heap, std::pop_heap, std::min, std::max
+#include <array>     // std::array
+#include <cstdlib>   // std::abs
+#include <vector>    // std::vector
+
+// 邻域类型
+enum class Neighborhood {
+    Four,  // 4 邻域：上下左右
+    Eight  // 8 邻域：增加四个对角方向，不允许穿过墙角
+};
+
+// 启发函数类型
+enum class HeuristicKind {
+    Manhattan, // 曼哈顿距离（4 邻域下可采纳）
+    Octile,    // 八方向距离（8 邻域下可采纳）
+    Zero       // 恒为 0，即 Dijkstra 算法
+};
+
+// 寻路选项
+struct SolverOptions {
+    Neighborhood neighborhood = Neighborhood::Four;
+    HeuristicKind heuristic = HeuristicKind::Manhattan;
+};
+
+// 从命令行/请求中的文字解析选项："4" / "8"，"manhattan" / "octile" / "zero"
+bool parseNeighborhood(const QString &text, Neighborhood &neighborhood);
+bool parseHeuristic(const QString &text, HeuristicKind &heuristic);
+QString heuristicName(HeuristicKind heuristic);
+
+// 8 邻域下曼哈顿距离会高估斜向移动的代价（最多高估 6 * min(dx, dy)），不可采纳，A* 不再保证找到最短路径。
+// 因此 8 邻域下选择曼哈顿距离时改用八方向距离；其余组合都可采纳，原样返回。
+SolverOptions admissibleOptions(SolverOptions options);
+
+// 代价单位：直行一步为 10，斜行一步为 14（约等于 10 * sqrt(2)），全部用整数计算
+const int kStraightCost = 10;
+const int kDiagonalCost = 14;
+
+// 路径总代价（同上单位）
+int pathCost(const CompactPath &path);
+
+// ---------------- 邻域 ----------------
+// 方向表在编译期确定；按单元格编号的偏移量由网格行间隔 stride 计算（constexpr），
+// 在一次搜索开始时算好，内层循环中只做加法。
+
+struct FourConnected {
+    static constexpr int kCount = 4;
+    static constexpr std::array<int, kCount> dx = {0, 1, 0, -1};
+    static constexpr std::array<int, kCount> dy = {1, 0, -1, 0};
+    static constexpr std::array<int, kCount> cost = {kStraightCost, kStraightCost, kStraightCost, kStraightCost};
+
+    static constexpr std::array<int, kCount> offsets(int stride) {
+        return {stride, 1, -stride, -1};
+    }
+
+    // 4 邻域没有对角移动，无需检查墙角
+    static bool cornerClear(const int *, int, int, int) { return true; }
+};
+
+struct EightConnected {
+    static constexpr int kCount = 8;
+    static constexpr std::array<int, kCount> dx = {0, 1, 0, -1, 1, 1, -1, -1};
+    static constexpr std::array<int, kCount> dy = {1, 0, -1, 0, 1, -1, 1, -1};
+    static constexpr std::array<int, kCount> cost = {kStraightCost, kStraightCost, kStraightCost, kStraightCost,
+                                                     kDiagonalCost, kDiagonalCost, kDiagonalCost, kDiagonalCost};
+
+    static constexpr std::array<int, kCount> offsets(int stride) {
+        return {stride, 1, -stride, -1, stride + 1, -stride + 1, stride - 1, -stride - 1};
+    }
+
+    // 墙角规则：斜向移动时，两侧相邻的两个直行单元格都必须是通路，
+    // 否则机器人会擦着墙角穿过去
+    static bool cornerClear(const int *cells, int cell, int stride, int k) {
+        if (k < 4) return true;
+        return cells[cell + dx[k]] != 1 && cells[cell + dy[k] * stride] != 1;
+    }
+};
+
+// ---------------- 启发函数 ----------------
+
+struct ManhattanHeuristic {
+    static int estimate(int dx, int dy) { return kStraightCost * (dx + dy); }
+};
+
+struct OctileHeuristic {
+    static int estimate(int dx, int dy) {
+        return kDiagonalCost * std::min(dx, dy) + kStraightCost * (std::max(dx, dy) - std::min(dx, dy));
+    }
+};
+
+struct ZeroHeuristic {
+    static int estimate(int, int) { return 0; }
+};
+
+// 搜索工作区：按单元格编号分配的数组在多次搜索之间复用。
+// 用代号（stamp）标记本次搜索写入过的单元格，开始新搜索时无需清空整个数组。
+struct SolverWorkspace {
+    std::vector<int> g;           // 起点到该单元格的最小代价
+    std::vector<int> parent;      // 父单元格编号，-1 表示起点
+    std::vector<quint32> seen;    // 该单元格 g/parent 有效时等于 stamp
+    std::vector<quint32> closed;  // 该单元格已出队扩展（或被阻塞）时等于 stamp
+    quint32 stamp = 0;
+
+    // 开放列表元素：f 小者优先，f 相同时 g 大者（更接近终点）优先
+    struct OpenEntry {
+        int f;
+        int g;
+        int cell;
+        bool operator<(const OpenEntry &o) const {
+            if (f != o.f) return f > o.f;
+            return g < o.g;
+        }
+    };
+    std::vector<OpenEntry> open;
+
+    std::vector<int> h; // 多目标搜索中缓存的启发值，seen == stamp 时有效；只在多目标搜索时分配
+
+    qint64 expanded = 0; // 最近一次搜索扩展的单元格数
+
+    // 开始一次新搜索
+    void reset(int cellCount) {
+        if (static_cast<int>(seen.size()) < cellCount) {
+            g.resize(cellCount);
+            parent.resize(cellCount);
+            seen.resize(cellCount, 0);
+            closed.resize(cellCount, 0);
+        }
+        if (++stamp == 0) { // 代号回绕时真正清空一次
+            std::fill(seen.begin(), seen.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            stamp = 1;
+        }
+        open.clear();
+        expanded = 0;
+    }
+};
+
+// 以邻域和启发函数为模板参数的 A* 搜索主循环
+// 内层循环中没有分支选择邻域或启发函数，也没有虚函数调用。
+// 搜索结束后 ws.parent 记录了搜索树；goalCell 为 -1 时不设终点，搜索遍历整个连通区域。
+template <class N, class H>
+bool searchGrid(const MazeView &view, int startCell, int goalCell,
+                SolverWorkspace &ws, const QVector<QPoint> &blocked)
+{
+    const int stride = view.stride;
+    const int *cells = view.cells;
+    const std::array<int, N::kCount> offsets = N::offsets(stride);
+
+    ws.reset(view.cellCount());
+    const quint32 stamp = ws.stamp;
+
+    // 阻塞点直接标记为已关闭
+    for (const QPoint &b : blocked)
+        if (view.inBounds(b))
+            ws.closed[view.index(b)] = stamp;
+
+    if (ws.closed[startCell] == stamp || (goalCell >= 0 && ws.closed[goalCell] == stamp))
+        return false;
+
+    const int gx = goalCell >= 0 ? goalCell % stride : 0;
+    const int gy = goalCell >= 0 ? goalCell / stride : 0;
+    auto estimate = [&](int cell) {
+        return H::estimate(std::abs(cell % stride - gx), std::abs(cell / stride - gy));
+    };
+
+    ws.g[startCell] = 0;
+    ws.parent[startCell] = -1;
+    ws.seen[startCell] = stamp;
+    ws.open.push_back({estimate(startCell), 0, startCell});
+
+    while (!ws.open.empty()) {
+        std::pop_heap(ws.open.begin(), ws.open.end());
+        const SolverWorkspace::OpenEntry top = ws.open.back();
+        ws.open.pop_back();
+
+        const int cell = top.cell;
+        // 懒删除：同一单元格可能以不同代价多次入队，只处理第一次出队
+        if (ws.closed[cell] == stamp) continue;
+        ws.closed[cell] = stamp;
+        ++ws.expanded;
+
+        if (cell == goalCell)
+            return true;
+
+        const int x = cell % stride;
+        const int y = cell / stride;
+        // 内部单元格的所有邻居都在边界内，只有边界上的单元格才需要逐个检查越界
+        const bool interior = x > 0 && x < view.cols - 1 && y > 0 && y < view.rows - 1;
+
+        for (int k = 0; k < N::kCount; ++k) {
+            if (!interior && !view.inBounds(x + N::dx[k], y + N::dy[k])) continue;
+            const int next = cell + offsets[k];
+            if (cells[next] == 1 || ws.closed[next] == stamp) continue;
+            // 斜向邻居在边界内时，两侧的直行单元格也一定在边界内
+            if (!N::cornerClear(cells, cell, stride, k)) continue;
+
+            const int tentative = top.g + N::cost[k];
+            if (ws.seen[next] == stamp && tentative >= ws.g[next]) continue;
+
+            ws.g[next] = tentative;
+            ws.parent[next] = cell;
+            ws.seen[next] = stamp;
+            ws.open.push_back({tentative + estimate(next), tentative, next});
+            std::push_heap(ws.open.begin(), ws.open.end());
+        }
+    }
+    return false;
+}
+
+// A* 寻路：找到路径时 path 为从 start 到 goal 的紧凑路径（包含两端）
+template <class N, class H>
+bool solveGrid(const MazeView &view, const QPoint &start, const QPoint &goal,
+               SolverWorkspace &ws, CompactPath &path, const QVector<QPoint> &blocked)
+{
+    const int stride = view.stride;
+    const int goalCell = view.index(goal);
+    if (!searchGrid<N, H>(view, view.index(start), goalCell, ws, blocked))
+        return false;
+
+    // 从终点沿父指针回溯：先数出步数，再按下标从后往前直接写入方向编码，无需反转
+    int steps = 0;
+    for (int c = goalCell; ws.parent[c] != -1; c = ws.parent[c]) ++steps;
+    path = CompactPath(start, steps, N::kCount == 4 ? 2 : 3);
+    for (int c = goalCell; ws.parent[c] != -1; c = ws.parent[c]) {
+        const int p = ws.parent[c];
+        path.setStep(--steps, CompactPath::directionCode(c % stride - p % stride, c / stride - p / stride));
+    }
+    return true;
+}
+
+// 多源多目标 A* 搜索：所有起点同时以代价 0 入队，启发值为到最近目标的估计（见 GoalSet），
+// 第一个出队的目标即为离任一起点最近的目标。返回该目标的单元格编号，找不到时返回 -1。
+// 启发值的计算需要查询空间索引，因此每个单元格只在第一次入队时计算一次，缓存在 ws.h 中。
+template <class N, class H>
+int searchNearest(const MazeView &view, const QVector<QPoint> &sources, const GoalSet &goals, SolverWorkspace &ws)
+{
+    const int stride = view.stride;
+    const int *cells = view.cells;
+    const std::array<int, N::kCount> offsets = N::offsets(stride);
+
+    ws.reset(view.cellCount());
+    if (static_cast<int>(ws.h.size()) < view.cellCount())
+        ws.h.resize(view.cellCount());
+    const quint32 stamp = ws.stamp;
+    if (goals.isEmpty())
+        return -1;
+
+    for (const QPoint &s : sources) {
+        if (!view.isOpen(s)) continue;
+        const int cell = view.index(s);
+        if (ws.seen[cell] == stamp) continue; // 重复的起点
+        ws.g[cell] = 0;
+        ws.parent[cell] = -1;
+        ws.seen[cell] = stamp;
+        ws.h[cell] = goals.estimate<H>(s.x(), s.y());
+        ws.open.push_back({ws.h[cell], 0, cell});
+        std::push_heap(ws.open.begin(), ws.open.end());
+    }
+
+    while (!ws.open.empty()) {
+        std::pop_heap(ws.open.begin(), ws.open.end());
+        const SolverWorkspace::OpenEntry top = ws.open.back();
+        ws.open.pop_back();
+
+        const int cell = top.cell;
+        if (ws.closed[cell] == stamp) continue;
+        ws.closed[cell] = stamp;
+        ++ws.expanded;
+
+        const int x = cell % stride;
+        const int y = cell / stride;
+        if (goals.goalAt(x, y) >= 0)
+            return cell;
+
+        const bool interior = x > 0 && x < view.cols - 1 && y > 0 && y < view.rows - 1;
+        for (int k = 0; k < N::kCount; ++k) {
+            if (!interior && !view.inBounds(x + N::dx[k], y + N::dy[k])) continue;
+            const int next = cell + offsets[k];
+            if (cells[next] == 1 || ws.closed[next] == stamp) continue;
+            if (!N::cornerClear(cells, cell, stride, k)) continue;
+
+            const int tentative = top.g + N::cost[k];
+            if (ws.seen[next] == stamp) {
+                if (tentative >= ws.g[next]) continue;
+            } else {
+                ws.h[next] = goals.estimate<H>(x + N::dx[k], y + N::dy[k]);
+                ws.seen[next] = stamp;
+            }
+
+            ws.g[next] = tentative;
+            ws.parent[next] = cell;
+            ws.open.push_back({tentative + ws.h[next], tentative, next});
+            std::push_heap(ws.open.begin(), ws.open.end());
+        }
+    }
+    return -1;
+}
+
+// 以 root 为根的最短路径树（对整个连通区域做 Dijkstra）
+// next[c] 为从 c 出发走向 root 的下一个单元格；root 处为 -1，不可达处为 -2。
+// 移动代价和墙角规则都是对称的，因此这棵树给出的是任意单元格到 root 的最短路径。
+template <class N>
+void buildPathTree(const MazeView &view, const QPoint &root, SolverWorkspace &ws, std::vector<int> &next)
+{
+    searchGrid<N, ZeroHeuristic>(view, view.index(root), -1, ws, {});
+    next.assign(view.cellCount(), -2);
+    for (int c = 0; c < view.cellCount(); ++c)
+        if (ws.closed[c] == ws.stamp)
+            next[c] = ws.parent[c];
+}
+
+// 多源多目标查询的结果
+struct NearestResult {
+    int source = -1; // 路径起点在 sources 中的下标
+    int goal = -1;   // 到达的目标在 goals.points() 中的下标
+    int cost = 0;    // 路径代价（单位同 kStraightCost）
+};
+
+// 唯一的运行时分派点：根据选项选择对应的模板实例
+bool findPath(const MazeView &view, const QPoint &start, const QPoint &goal,
+              const SolverOptions &options, SolverWorkspace &ws, CompactPath &path,
+              const QVector<QPoint> &blocked = {});
+
+// 多源多目标查询：一次搜索找出离任一起点最近的目标，path 为从该起点到该目标的路径
+bool findNearest(const MazeView &view, const QVector<QPoint> &sources, const GoalSet &goals,
+                 const SolverOptions &options, SolverWorkspace &ws, CompactPath &path,
+                 NearestResult *result = nullptr);
+
+// 构建以 root 为根的最短路径树（见 buildPathTree），按邻域分派
+void buildShortestPathTree(const MazeView &view, const QPoint &root, Neighborhood neighborhood,
+                           SolverWorkspace &ws, std::vector<int> &next);
+
+#endif // PATHSOLVER_H
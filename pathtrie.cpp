@@ -0,0 +1,80 @@
+#include "pathtrie.h"
+
+#include <algorithm> // std::stable_sort
+
+void PathTrie::reset(const QPoint &start, int bitsPerStep) {
+    clear();
+    origin = start;
+    bits = bitsPerStep;
+}
+
+void PathTrie::clear() {
+    // 释放段和编码池，避免枚举大量路径后一直占着内存
+    std::vector<Segment>().swap(segments);
+    std::vector<quint32>().swap(order);
+    std::vector<quint64>().swap(codes);
+    codeCount = 0;
+    pendingCodes.clear();
+    pendingSegments.clear();
+}
+
+void PathTrie::appendCode(int value) {
+    const int perWord = 64 / bits;
+    if (codeCount % perWord == 0)
+        codes.push_back(0);
+    codes.back() |= static_cast<quint64>(value) << ((codeCount % perWord) * bits);
+    ++codeCount;
+}
+
+int PathTrie::commit() {
+    // 已入池的前缀直接复用，只把其后的新步骤写成一个段
+    const quint32 id = static_cast<quint32>(segments.size());
+    const quint32 shared = static_cast<quint32>(pendingSegments.size());
+    Segment segment;
+    segment.parent = shared > 0 ? pendingSegments.back() : id;
+    segment.start = shared;
+    segment.offset = static_cast<quint32>(codeCount);
+    segment.length = static_cast<quint32>(pendingCodes.size()) - shared;
+    for (size_t d = shared; d < pendingCodes.size(); ++d) {
+        appendCode(pendingCodes[d]);
+        pendingSegments.push_back(id);
+    }
+    segments.push_back(segment);
+    order.push_back(id);
+    return static_cast<int>(order.size()) - 1;
+}
+
+void PathTrie::sortByLength() {
+    std::stable_sort(order.begin(), order.end(), [this](quint32 a, quint32 b) {
+        return segments[a].start + segments[a].length < segments[b].start + segments[b].length;
+    });
+}
+
+CompactPath PathTrie::path(int i) const {
+    // 从最后一段往回，逐段填写该段负责的那部分步骤
+    quint32 n = order[i];
+    quint32 limit = segments[n].start + segments[n].length;
+    CompactPath result(origin, static_cast<int>(limit), bits);
+    while (limit > 0) {
+        const Segment &s = segments[n];
+        for (quint32 d = s.start; d < limit; ++d)
+            result.setStep(static_cast<int>(d), code(s.offset + (d - s.start)));
+        limit = s.start;
+        n = s.parent;
+    }
+    return result;
+}
+
+qint64 PathTrie::memoryBytes() const {
+    return static_cast<qint64>(segments.capacity() * sizeof(Segment) + order.capacity() * sizeof(quint32) + codes.capacity() * sizeof(quint64));
+}
+
+qint64 PathTrie::flatMemoryBytes() const {
+    // 每条路径一个 CompactPath 对象加上其编码数据
+    const int perWord = 64 / bits;
+    qint64 total = 0;
+    for (const Segment &s : segments)
+        total += static_cast<qint64>(sizeof(CompactPath))
+                 + static_cast<qint64>((s.start + s.length + perWord - 1) / perWord) * static_cast<qint64>(sizeof(quint64));
+    return total;
+}
@@ -0,0 +1,87 @@
+#ifndef PATHTRIE_H
+#define PATHTRIE_H
+
+#include <QPoint>
+#include <QtGlobal>
+
+#include <vector> // std::vector
+
+#include "compactpath.h"
+
+// 前缀共享的路径存储
+// 深度优先枚举出的路径都从同一个起点出发，彼此共享很长的公共前缀。
+// 这里把所有路径存成一棵以起点为根的压缩前缀树：每条路径只新增一个"段"结点，
+// 记录它从父段的第几步分叉出来，以及分叉之后的各步方向编码；编码按位紧凑地追加在一个共享的编码池中，
+// 公共前缀只存一次。内存约为 每条路径 20 字节 + 所有不同步骤各 2/3 位。
+// 按长度排序只重排路径编号，不复制路径；只有真正要播放某条路径时，
+// 才用 path() 沿父段指针把它展开成 CompactPath。
+class PathTrie
+{
+public:
+    PathTrie() = default;
+
+    // 清空并以 start 为根开始新一轮枚举
+    // bitsPerStep: 每步方向编码占用的位数，含义同 CompactPath
+    void reset(const QPoint &start, int bitsPerStep = 2);
+    void clear();
+
+    // ---------- 枚举接口 ----------
+    // DFS 前进一步时 push()，回溯时 pop()。当前路径只是一个方向栈，
+    // 到达终点调用 commit() 时才把尚未入池的后缀写成一个段，死胡同分支不占用编码池。
+    void push(int code) { pendingCodes.push_back(static_cast<quint8>(code)); }
+    void pop() {
+        pendingCodes.pop_back();
+        if (pendingSegments.size() > pendingCodes.size())
+            pendingSegments.pop_back();
+    }
+    int depth() const { return static_cast<int>(pendingCodes.size()); } // 当前路径的步数
+    int commit(); // 把当前路径存为一条完整路径，返回路径编号
+
+    // ---------- 查询接口 ----------
+    bool isEmpty() const { return order.empty(); }
+    int size() const { return static_cast<int>(order.size()); } // 路径条数
+    int steps(int i) const {
+        const Segment &s = segments[order[i]];
+        return static_cast<int>(s.start + s.length);
+    }
+    QPoint start() const { return origin; }
+
+    // 按步数升序重排路径编号，步数相同的保持枚举顺序；段和编码池不动
+    void sortByLength();
+
+    // 把第 i 条路径展开为 CompactPath（用于动画）
+    CompactPath path(int i) const;
+
+    // 内存统计：段数、本存储占用的字节数，以及把各条路径分别存为 CompactPath 时需要的字节数
+    int segmentCount() const { return static_cast<int>(segments.size()); }
+    qint64 memoryBytes() const;
+    qint64 flatMemoryBytes() const;
+
+private:
+    // 一个段覆盖路径上第 [start, start + length) 步，编码在编码池中从 offset 开始；
+    // 第 start 步之前的部分沿用父段（及其祖先）的编码。start 为 0 时没有父段。
+    struct Segment {
+        quint32 parent;
+        quint32 start;
+        quint32 offset;
+        quint32 length;
+    };
+
+    int code(quint64 index) const {
+        const int perWord = 64 / bits;
+        return static_cast<int>((codes[index / perWord] >> ((index % perWord) * bits)) & ((1u << bits) - 1));
+    }
+    void appendCode(int value);
+
+    QPoint origin;
+    int bits = 2;
+    std::vector<Segment> segments; // 每条路径一个段，下标即段号
+    std::vector<quint32> order;    // 路径编号 -> 段号，排序只重排这里
+    std::vector<quint64> codes;    // 编码池，所有段的方向编码按位紧凑存放
+    quint64 codeCount = 0;
+
+    std::vector<quint8> pendingCodes;     // 当前枚举路径的方向栈
+    std::vector<quint32> pendingSegments; // 当前路径已入池的前缀中，每一步所在的段
+};
+
+#endif // PATHTRIE_H
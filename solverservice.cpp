@@ -0,0 +1,465 @@
+#include "solverservice.h"
+
+#include "compactpath.h"
+#include "componentlabels.h"
+#include "jsonlines.h"
+#include "latencyhistogram.h"
+#include "mazegenerator.h"
+#include "mazegrid.h"
+#include "mazeio.h"
+#include "pathcache.h"
+#include "pathsolver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <atomic> // std::atomic
+#include <deque>  // std::deque
+#include <map>    // std::map
+#include <memory> // std::unique_ptr
+
+const char *const SolverService::kFlag = "--serve";
+
+namespace {
+
+// 每个连接最多同时在处理中的请求数；超过后暂停读取，等回复发出后再继续（背压）
+const int kMaxInFlight = 1024;
+
+// SAMPLE 一次最多返回的单元格数
+const int kMaxSample = 65536;
+
+// 常驻内存的迷宫及其加速结构
+// 网格和连通区域标记在启动后只读，多个工作线程可以同时使用；结果缓存由互斥锁保护，
+// 只在查找和存入时加锁，搜索本身在锁外进行。
+struct ServedMaze {
+    QString name;
+    MazeGrid grid;
+    ComponentLabels components;
+    QMutex cacheMutex;
+    PathCache cache;
+
+    explicit ServedMaze(int cacheCapacity) : cache(cacheCapacity) {}
+};
+
+// 服务全局状态：迷宫表在启动后只读，计数器和直方图都是原子的
+struct ServiceState {
+    std::map<QString, std::unique_ptr<ServedMaze>> mazes;
+    SolverOptions defaults;
+    LatencyHistogram latency; // 从读到请求到回复就绪的服务端延迟
+    std::atomic<qint64> queries{0};
+    std::atomic<qint64> found{0};
+    std::atomic<qint64> rejected{0}; // 起终点不连通、未经搜索直接回答的查询
+    std::atomic<qint64> errors{0};
+    std::atomic<qint64> expanded{0};
+    QElapsedTimer uptime;
+};
+
+QByteArray errorReply(const QString &message) {
+    return "ERR " + message.toUtf8() + '\n';
+}
+
+// 处理一条 SOLVE 请求，在工作线程中执行
+QByteArray solveRequest(ServiceState &state, const QList<QByteArray> &parts) {
+    if (parts.size() < 6 || parts.size() > 8)
+        return errorReply("用法: SOLVE <迷宫> <sx> <sy> <ex> <ey> [4|8] [启发函数]");
+
+    auto it = state.mazes.find(QString::fromUtf8(parts[1]));
+    if (it == state.mazes.end())
+        return errorReply("未知迷宫 " + QString::fromUtf8(parts[1]));
+
+    bool ok[4] = {false, false, false, false};
+    const QPoint start(parts[2].toInt(&ok[0]), parts[3].toInt(&ok[1]));
+    const QPoint end(parts[4].toInt(&ok[2]), parts[5].toInt(&ok[3]));
+    if (!(ok[0] && ok[1] && ok[2] && ok[3]))
+        return errorReply("坐标必须是整数");
+
+    SolverOptions options = state.defaults;
+    if (parts.size() > 6 && !parseNeighborhood(QString::fromLatin1(parts[6]), options.neighborhood))
+        return errorReply("邻域只能是 4 或 8");
+    if (parts.size() > 7 && !parseHeuristic(QString::fromLatin1(parts[7]), options.heuristic))
+        return errorReply("启发函数只能是 manhattan、octile 或 zero");
+    options = admissibleOptions(options);
+
+    ServedMaze &maze = *it->second;
+    if (!maze.grid.view().isOpen(start) || !maze.grid.view().isOpen(end))
+        return "NONE\n"; // 越界或墙壁：不可达，但不计入"不连通"
+    if (!maze.components.connected(maze.grid.view(), start, end)) {
+        ++state.rejected;
+        return "NONE\n";
+    }
+
+    bool found = false;
+    CompactPath path;
+    bool cached = false;
+    {
+        QMutexLocker lock(&maze.cacheMutex);
+        cached = maze.cache.lookup(start, end, options, found, path);
+    }
+    if (!cached) {
+        // 每个工作线程一份工作区，反复使用，不必每次分配
+        thread_local SolverWorkspace workspace;
+        found = findPath(maze.grid.view(), start, end, options, workspace, path);
+        state.expanded += workspace.expanded;
+        QMutexLocker lock(&maze.cacheMutex);
+        maze.cache.store(start, end, options, found, path);
+    }
+
+    if (!found)
+        return "NONE\n";
+    QByteArray reply = "OK " + QByteArray::number(path.steps()) + ' '
+            + QByteArray::number(static_cast<double>(pathCost(path)) / kStraightCost);
+    if (path.steps() > 0)
+        reply += ' ' + path.codeString().toLatin1();
+    reply += '\n';
+    return reply;
+}
+
+QByteArray mazesReply(const ServiceState &state) {
+    QByteArray reply = "MAZES";
+    for (const auto &entry : state.mazes) {
+        const MazeGrid &grid = entry.second->grid;
+        reply += ' ' + entry.first.toUtf8() + ':' + QByteArray::number(grid.rows) + 'x' + QByteArray::number(grid.cols);
+    }
+    reply += '\n';
+    return reply;
+}
+
+// 处理一条 SAMPLE 请求：随机给出迷宫中的 n 个通路单元格，供客户端生成查询
+// 按随机坐标试探，不必列出全部通路；通路极少时可能少于 n 个
+QByteArray sampleReply(const ServiceState &state, const QList<QByteArray> &parts) {
+    if (parts.size() < 3 || parts.size() > 4)
+        return errorReply("用法: SAMPLE <迷宫> <n> [种子]");
+    auto it = state.mazes.find(QString::fromUtf8(parts[1]));
+    if (it == state.mazes.end())
+        return errorReply("未知迷宫 " + QString::fromUtf8(parts[1]));
+    bool ok = false;
+    const int n = parts[2].toInt(&ok);
+    if (!ok || n < 1 || n > kMaxSample)
+        return errorReply(QString("n 必须在 1 到 %1 之间").arg(kMaxSample));
+
+    const MazeView view = it->second->grid.view();
+    QRandomGenerator rng(parts.size() > 3 ? parts[3].toUInt() : 1);
+    QByteArray reply = "CELLS";
+    int count = 0;
+    for (qint64 attempt = 0; count < n && attempt < static_cast<qint64>(n) * 64; ++attempt) {
+        const int x = static_cast<int>(rng.bounded(static_cast<quint32>(view.cols)));
+        const int y = static_cast<int>(rng.bounded(static_cast<quint32>(view.rows)));
+        if (!view.isOpen(x, y)) continue;
+        reply += ' ' + QByteArray::number(x) + ' ' + QByteArray::number(y);
+        ++count;
+    }
+    reply += '\n';
+    return reply;
+}
+
+qint64 cacheHits(ServiceState &state) {
+    qint64 hits = 0;
+    for (auto &entry : state.mazes) {
+        QMutexLocker lock(&entry.second->cacheMutex);
+        hits += entry.second->cache.stats().hits;
+    }
+    return hits;
+}
+
+double queriesPerSecond(qint64 queries, qint64 elapsedNs) {
+    return elapsedNs > 0 ? queries / (elapsedNs / 1e9) : 0.0;
+}
+
+QByteArray statsReply(ServiceState &state) {
+    const qint64 elapsed = state.uptime.nsecsElapsed();
+    const qint64 queries = state.queries.load();
+    return "STATS queries=" + QByteArray::number(queries)
+            + " found=" + QByteArray::number(state.found.load())
+            + " rejected=" + QByteArray::number(state.rejected.load())
+            + " errors=" + QByteArray::number(state.errors.load())
+            + " qps=" + QByteArray::number(queriesPerSecond(queries, elapsed), 'f', 1)
+            + " p50us=" + QByteArray::number(state.latency.percentile(50) / 1000.0, 'f', 1)
+            + " p99us=" + QByteArray::number(state.latency.percentile(99) / 1000.0, 'f', 1)
+            + " cacheHits=" + QByteArray::number(cacheHits(state))
+            + " uptimeMs=" + QByteArray::number(elapsed / 1000000) + '\n';
+}
+
+// 一个客户端连接
+// 只在主线程中使用。请求按到达顺序编号，回复在工作线程中生成后投递回主线程，
+// 按编号顺序排队写出，因此同一连接上的流水线请求总是按顺序得到回复。
+// 连接断开后，等所有在途请求都完成才删除自身，保证工作线程投递回来时对象仍然存在。
+class Connection : public QObject
+{
+public:
+    Connection(QIODevice *device, ServiceState &serviceState, QThreadPool &workerPool)
+        : socket(device), state(serviceState), pool(workerPool)
+    {
+        socket->setParent(this);
+        connect(socket, &QIODevice::readyRead, this, [this]() { readRequests(); });
+    }
+
+    void close() {
+        closing = true;
+        if (pending.empty())
+            deleteLater();
+    }
+
+private:
+    struct Pending {
+        bool done = false;
+        QByteArray reply;
+        QElapsedTimer timer;
+    };
+
+    QIODevice *socket;
+    ServiceState &state;
+    QThreadPool &pool;
+    std::deque<Pending> pending; // 尚未写出的回复，按请求顺序
+    qint64 firstSeq = 0;         // pending.front() 的请求编号
+    bool paused = false;         // 因在途请求过多而暂停读取
+    bool closing = false;
+
+    void readRequests() {
+        while (!closing && static_cast<int>(pending.size()) < kMaxInFlight && socket->canReadLine()) {
+            const QByteArray line = socket->readLine().simplified();
+            if (line.isEmpty()) continue;
+
+            const qint64 seq = firstSeq + static_cast<qint64>(pending.size());
+            pending.emplace_back();
+            pending.back().timer.start();
+
+            const QList<QByteArray> parts = line.split(' ');
+            const QByteArray command = parts[0].toUpper();
+            if (command == "SOLVE") {
+                pool.start([this, seq, parts]() {
+                    QByteArray reply = solveRequest(state, parts);
+                    QMetaObject::invokeMethod(this, [this, seq, reply]() { complete(seq, reply); },
+                                              Qt::QueuedConnection);
+                });
+            } else if (command == "MAZES") {
+                complete(seq, mazesReply(state));
+            } else if (command == "SAMPLE") {
+                complete(seq, sampleReply(state, parts));
+            } else if (command == "STATS") {
+                complete(seq, statsReply(state));
+            } else {
+                complete(seq, errorReply("未知命令 " + QString::fromUtf8(parts[0])));
+            }
+        }
+        paused = !closing && socket->canReadLine();
+    }
+
+    void complete(qint64 seq, const QByteArray &reply) {
+        Pending &p = pending[static_cast<size_t>(seq - firstSeq)];
+        p.done = true;
+        p.reply = reply;
+        if (reply.startsWith("ERR")) {
+            ++state.errors;
+        } else if (reply.startsWith("OK") || reply.startsWith("NONE")) {
+            state.latency.record(p.timer.nsecsElapsed());
+            ++state.queries;
+            if (reply.startsWith("OK")) ++state.found;
+        }
+        flush();
+    }
+
+    // 把队首已完成的回复合并成一次写出
+    void flush() {
+        QByteArray out;
+        while (!pending.empty() && pending.front().done) {
+            out += pending.front().reply;
+            pending.pop_front();
+            ++firstSeq;
+        }
+        if (!out.isEmpty() && !closing)
+            socket->write(out);
+
+        if (closing) {
+            if (pending.empty())
+                deleteLater();
+        } else if (paused && static_cast<int>(pending.size()) < kMaxInFlight) {
+            paused = false;
+            readRequests(); // 继续读取之前因背压暂停的请求
+        }
+    }
+};
+
+// 加载 "名称=文件" 形式的迷宫
+bool addLoadedMaze(ServiceState &state, const QString &spec, int cacheCapacity, QString &error) {
+    const int eq = spec.indexOf('=');
+    if (eq <= 0) {
+        error = QString("--maze 的格式应为 <名称>=<文件>：%1").arg(spec);
+        return false;
+    }
+    const QString name = spec.left(eq);
+    auto maze = std::make_unique<ServedMaze>(cacheCapacity);
+    maze->name = name;
+    QString loadError;
+    if (!loadMazeText(spec.mid(eq + 1), maze->grid, &loadError)) {
+        error = QString("%1：%2").arg(spec.mid(eq + 1), loadError);
+        return false;
+    }
+    state.mazes[name] = std::move(maze);
+    return true;
+}
+
+// 生成 "名称=RxC" 形式的迷宫
+bool addGeneratedMaze(ServiceState &state, const QString &spec, quint32 seed, int cacheCapacity, QString &error) {
+    const int eq = spec.indexOf('=');
+    int rows = 0, cols = 0;
+    if (eq <= 0 || !parseMazeSize(spec.mid(eq + 1), rows, cols)) {
+        error = QString("--generate 的格式应为 <名称>=<行数>x<列数>：%1").arg(spec);
+        return false;
+    }
+    const QString name = spec.left(eq);
+    auto maze = std::make_unique<ServedMaze>(cacheCapacity);
+    maze->name = name;
+    maze->grid.resize(rows, cols);
+    MazeGenerator::generate(maze->grid.data(), rows, cols, cols, seed);
+    state.mazes[name] = std::move(maze);
+    return true;
+}
+
+} // namespace
+
+int SolverService::run(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("常驻寻路服务：预加载迷宫，通过本地套接字或 TCP 回答流水线寻路请求。");
+    parser.addHelpOption();
+
+    QCommandLineOption serveOption("serve", "进入服务模式（必须）。");
+    QCommandLineOption socketOption("socket", "本地套接字名称。", "name", "mazerobot");
+    QCommandLineOption portOption("port", "改为监听 127.0.0.1 上的 TCP 端口。", "port");
+    QCommandLineOption mazeOption("maze", "从文本文件加载迷宫，可重复。", "name=file");
+    QCommandLineOption generateOption("generate", "生成迷宫，可重复（都未指定时生成 default=101x101）。", "name=RxC");
+    QCommandLineOption seedOption("seed", "生成迷宫的种子。", "n", "1");
+    QCommandLineOption threadsOption("threads", "求解线程数，0 表示全部硬件线程。", "n", "0");
+    QCommandLineOption cacheOption("cache", "每个迷宫缓存的查询结果数。", "n", "4096");
+    QCommandLineOption neighborhoodOption("neighborhood", "请求未指定时的邻域：4 或 8。", "4|8", "4");
+    QCommandLineOption heuristicOption("heuristic", "请求未指定时的启发函数；8 邻域下 manhattan 改用 octile。", "name", "manhattan");
+    QCommandLineOption reportOption("report-interval", "定期输出统计的间隔秒数，0 表示不输出。", "seconds", "10");
+    parser.addOptions({serveOption, socketOption, portOption, mazeOption, generateOption, seedOption,
+                       threadsOption, cacheOption, neighborhoodOption, heuristicOption, reportOption});
+    parser.process(arguments);
+
+    ServiceState state;
+    if (!parseNeighborhood(parser.value(neighborhoodOption), state.defaults.neighborhood))
+        return failWith("--neighborhood 只能是 4 或 8。");
+    if (!parseHeuristic(parser.value(heuristicOption), state.defaults.heuristic))
+        return failWith("--heuristic 只能是 manhattan、octile 或 zero。");
+    state.defaults = admissibleOptions(state.defaults);
+
+    // ---------- 预加载迷宫 ----------
+    const int cacheCapacity = qMax(1, parser.value(cacheOption).toInt());
+    const quint32 seed = parser.value(seedOption).toUInt();
+    QString error;
+    for (const QString &spec : parser.values(mazeOption))
+        if (!addLoadedMaze(state, spec, cacheCapacity, error))
+            return failWith(error);
+    QStringList generated = parser.values(generateOption);
+    if (generated.isEmpty() && state.mazes.empty())
+        generated.append("default=101x101");
+    for (const QString &spec : generated)
+        if (!addGeneratedMaze(state, spec, seed, cacheCapacity, error))
+            return failWith(error);
+    for (auto &entry : state.mazes) {
+        entry.second->cache.setMazeHash(PathCache::hashMaze(entry.second->grid.view()));
+        entry.second->components.build(entry.second->grid.view());
+    }
+
+    // ---------- 工作线程池 ----------
+    // 声明在 state 之后，析构时先等所有任务结束
+    QThreadPool pool;
+    int threads = parser.value(threadsOption).toInt();
+    if (threads <= 0) threads = MazeGenerator::defaultThreadCount();
+    pool.setMaxThreadCount(threads);
+
+    // ---------- 监听 ----------
+    QLocalServer localServer;
+    QTcpServer tcpServer;
+    QJsonObject listening;
+    listening["type"] = "listening";
+    if (parser.isSet(portOption)) {
+        const quint16 port = static_cast<quint16>(parser.value(portOption).toUInt());
+        if (!tcpServer.listen(QHostAddress::LocalHost, port))
+            return failWith(QString("无法监听端口 %1：%2").arg(port).arg(tcpServer.errorString()));
+        QObject::connect(&tcpServer, &QTcpServer::newConnection, [&]() {
+            while (QTcpSocket *socket = tcpServer.nextPendingConnection()) {
+                socket->setSocketOption(QAbstractSocket::LowDelayOption, 1); // 小回复不等待合并
+                Connection *connection = new Connection(socket, state, pool);
+                QObject::connect(socket, &QTcpSocket::disconnected, connection, [connection]() { connection->close(); });
+            }
+        });
+        listening["port"] = tcpServer.serverPort();
+    } else {
+        const QString name = parser.value(socketOption);
+        // 先试着连接：有实例应答说明服务正在运行，不能删除它的套接字；
+        // 连接不上时才是上次异常退出留下的套接字文件，可以清理
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(500))
+            return failWith(QString("本地套接字 %1 上已有服务在运行。").arg(name));
+        QLocalServer::removeServer(name);
+        if (!localServer.listen(name))
+            return failWith(QString("无法监听本地套接字 %1：%2").arg(name, localServer.errorString()));
+        QObject::connect(&localServer, &QLocalServer::newConnection, [&]() {
+            while (QLocalSocket *socket = localServer.nextPendingConnection()) {
+                Connection *connection = new Connection(socket, state, pool);
+                QObject::connect(socket, &QLocalSocket::disconnected, connection, [connection]() { connection->close(); });
+            }
+        });
+        listening["socket"] = localServer.fullServerName();
+    }
+
+    QJsonArray mazeList;
+    for (const auto &entry : state.mazes) {
+        QJsonObject m;
+        m["name"] = entry.first;
+        m["rows"] = entry.second->grid.rows;
+        m["cols"] = entry.second->grid.cols;
+        m["components"] = entry.second->components.componentCount();
+        mazeList.append(m);
+    }
+    listening["mazes"] = mazeList;
+    listening["threads"] = threads;
+    emitLine(listening);
+    state.uptime.start();
+
+    // ---------- 定期统计 ----------
+    QTimer reportTimer;
+    qint64 lastQueries = 0;
+    qint64 lastNs = 0;
+    const int interval = parser.value(reportOption).toInt();
+    if (interval > 0) {
+        QObject::connect(&reportTimer, &QTimer::timeout, [&]() {
+            const qint64 queries = state.queries.load();
+            const qint64 now = state.uptime.nsecsElapsed();
+            if (queries == lastQueries) return; // 空闲时不输出
+            QJsonObject stats;
+            stats["type"] = "stats";
+            stats["queries"] = queries;
+            stats["found"] = state.found.load();
+            stats["rejected"] = state.rejected.load();
+            stats["errors"] = state.errors.load();
+            stats["expanded"] = state.expanded.load();
+            stats["cacheHits"] = cacheHits(state);
+            stats["qps"] = queriesPerSecond(queries - lastQueries, now - lastNs); // 本统计周期内
+            stats["p50us"] = state.latency.percentile(50) / 1000.0;
+            stats["p99us"] = state.latency.percentile(99) / 1000.0;
+            emitLine(stats);
+            lastQueries = queries;
+            lastNs = now;
+        });
+        reportTimer.start(interval * 1000);
+    }
+
+    return QCoreApplication::exec();
+}
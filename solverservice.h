@@ -0,0 +1,31 @@
+#ifndef SOLVERSERVICE_H
+#define SOLVERSERVICE_H
+
+#include <QStringList>
+
+// 常驻寻路服务
+// 用法：Mazerobot --serve [--socket 名称 | --port 端口] [--maze 名称=文件]... [--generate 名称=RxC]... [选项]
+// 启动时把若干个命名迷宫及其缓存等加速结构常驻内存，然后在本地套接字（Unix 域套接字 / 命名管道）
+// 或 127.0.0.1 的 TCP 端口上接受任意多个客户端连接。
+// 网络读写全部在主线程的事件循环中异步完成，求解分散到工作线程池中。
+//
+// 协议为按行的文本，客户端可以不等回复连续发送多条请求（流水线），
+// 每个连接上的回复严格按请求顺序返回：
+//   SOLVE <迷宫> <sx> <sy> <ex> <ey> [4|8] [manhattan|octile|zero]
+//       -> OK <步数> <代价> [方向编码串]    （代价以直行一步为 1，编码见 CompactPath）
+//       -> NONE                              （不可达）
+//   MAZES -> MAZES <名称>:<行数>x<列数> ...
+//   SAMPLE <迷宫> <n> [种子] -> CELLS <x> <y> <x> <y> ...   （随机的通路单元格，用于生成查询）
+//   STATS -> STATS queries=.. found=.. rejected=.. errors=.. qps=.. p50us=.. p99us=.. cacheHits=.. uptimeMs=..
+//   出错时回复 ERR <原因>
+class SolverService
+{
+public:
+    // 命令行中出现该参数时进入服务模式
+    static const char *const kFlag;
+
+    // 运行服务直到进程结束，返回进程退出码
+    static int run(const QStringList &arguments);
+};
+
+#endif // SOLVERSERVICE_H
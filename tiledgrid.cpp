@@ -0,0 +1,271 @@
+#include "tiledgrid.h"
+
+#include <QTextStream>
+#include <QtEndian>
+
+#include <cstring> // std::memcmp, std::memcpy
+
+namespace {
+
+const char kMagic[8] = {'M', 'Z', 'T', 'I', 'L', 'E', 'S', '1'};
+
+bool failWith(QString *error, const QString &message) {
+    if (error) *error = message;
+    return false;
+}
+
+// 块边长必须是 8 的倍数，使每块的每一行都占整数个字节
+bool validTileSize(int tileSize) {
+    return tileSize >= 16 && tileSize <= 4096 && tileSize % 8 == 0;
+}
+
+// 按行写入分块文件：缓存一行块（tileSize 行），写满或结束时整行块一次写出
+class TileWriter
+{
+public:
+    TileWriter(QFile &f, int width, int tileSize)
+        : file(f)
+        , cols(width)
+        , edge(tileSize)
+        , tilesX((width + tileSize - 1) / tileSize)
+        , tileBytes(static_cast<qint64>(tileSize) * tileSize / 8)
+    {
+        startBand();
+    }
+
+    // 追加一行，isWall(x) 给出第 x 列是否为墙壁
+    template <class IsWall>
+    bool appendRow(IsWall isWall) {
+        const int ly = rows % edge;
+        for (int x = 0; x < cols; ++x) {
+            if (isWall(x)) continue;
+            const int lx = x % edge;
+            const qint64 bit = static_cast<qint64>(ly) * edge + lx;
+            band[(x / edge) * tileBytes + (bit >> 3)] &= static_cast<char>(~(1u << (lx & 7)));
+        }
+        ++rows;
+        return rows % edge != 0 || flushBand();
+    }
+
+    // 写出最后一行不满的块并回填文件头
+    bool finish() {
+        if (rows % edge != 0 && !flushBand()) return false;
+        QByteArray header(TiledGrid::kHeaderBytes, '\0');
+        std::memcpy(header.data(), kMagic, sizeof(kMagic));
+        qToLittleEndian<quint32>(static_cast<quint32>(rows), header.data() + 8);
+        qToLittleEndian<quint32>(static_cast<quint32>(cols), header.data() + 12);
+        qToLittleEndian<quint32>(static_cast<quint32>(edge), header.data() + 16);
+        return file.seek(0) && file.write(header) == header.size();
+    }
+
+    int rowCount() const { return rows; }
+
+private:
+    // 新的一行块全部预置为墙壁，超出地图的部分因此自然是墙壁
+    void startBand() { band.fill(static_cast<char>(0xFF), tilesX * tileBytes); }
+
+    bool flushBand() {
+        if (file.write(band) != band.size()) return false;
+        startBand();
+        return true;
+    }
+
+    QFile &file;
+    int cols;
+    int edge;
+    int tilesX;
+    qint64 tileBytes;
+    int rows = 0;
+    QByteArray band;
+};
+
+// 创建分块文件并预留文件头
+bool createTileFile(QFile &file, QString *error) {
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return failWith(error, "无法写入分块文件。");
+    if (file.write(QByteArray(TiledGrid::kHeaderBytes, '\0')) != TiledGrid::kHeaderBytes)
+        return failWith(error, "写入分块文件失败。");
+    return true;
+}
+
+} // namespace
+
+TiledGrid::~TiledGrid() {
+    close();
+}
+
+bool TiledGrid::open(const QString &filePath, int maxResidentTiles, QString *error) {
+    close();
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return failWith(error, "无法打开分块文件。");
+
+    const QByteArray header = file.read(kHeaderBytes);
+    if (header.size() != kHeaderBytes || std::memcmp(header.constData(), kMagic, sizeof(kMagic)) != 0) {
+        file.close();
+        return failWith(error, "不是有效的分块迷宫文件。");
+    }
+    const quint32 r = qFromLittleEndian<quint32>(header.constData() + 8);
+    const quint32 c = qFromLittleEndian<quint32>(header.constData() + 12);
+    const quint32 t = qFromLittleEndian<quint32>(header.constData() + 16);
+    if (r == 0 || c == 0 || r > 0x7FFFFFFFu || c > 0x7FFFFFFFu || !validTileSize(static_cast<int>(qMin(t, 0xFFFFu)))) {
+        file.close();
+        return failWith(error, "分块文件头中的尺寸不正确。");
+    }
+    rowCount = static_cast<int>(r);
+    colCount = static_cast<int>(c);
+    tileEdge = static_cast<int>(t);
+    tileCols = (colCount + tileEdge - 1) / tileEdge;
+
+    const qint64 tileRows = (rowCount + tileEdge - 1) / tileEdge;
+    if (file.size() < kHeaderBytes + tileRows * tileCols * tileBytes()) {
+        file.close();
+        return failWith(error, "分块文件不完整。");
+    }
+
+    slots.resize(qMax(1, maxResidentTiles));
+    for (int i = static_cast<int>(slots.size()) - 1; i >= 0; --i)
+        freeSlots.push_back(i);
+    return true;
+}
+
+void TiledGrid::close() {
+    for (Slot &slot : slots)
+        release(slot);
+    slots.clear();
+    lru.clear();
+    where.clear();
+    freeSlots.clear();
+    lastTile = -1;
+    lastData = nullptr;
+    wallTile.clear();
+    if (file.isOpen())
+        file.close();
+}
+
+void TiledGrid::resetStats() {
+    counters = Stats();
+    counters.peakResident = static_cast<int>(lru.size());
+}
+
+void TiledGrid::release(Slot &slot) {
+    if (slot.mapped)
+        file.unmap(slot.mapped);
+    slot.mapped = nullptr;
+    slot.buffer.clear();
+    slot.data = nullptr;
+    slot.tile = -1;
+}
+
+void TiledGrid::tile(qint64 index) {
+    ++counters.lookups;
+    auto hit = where.find(index);
+    if (hit != where.end()) {
+        Slot &slot = slots[hit->second];
+        lru.splice(lru.begin(), lru, slot.position); // 移到表头
+        lastTile = index;
+        lastData = slot.data;
+        return;
+    }
+
+    // 缺块：取一个空槽，没有空槽时淘汰最久未用的块
+    int s;
+    if (!freeSlots.empty()) {
+        s = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        s = lru.back();
+        lru.pop_back();
+        where.erase(slots[s].tile);
+        release(slots[s]);
+        ++counters.evictions;
+    }
+
+    Slot &slot = slots[s];
+    const qint64 offset = kHeaderBytes + index * tileBytes();
+    slot.tile = index;
+    slot.mapped = file.map(offset, tileBytes());
+    if (slot.mapped) {
+        slot.data = slot.mapped;
+    } else {
+        // 文件系统不支持映射时退回普通读取
+        if (file.seek(offset))
+            slot.buffer = file.read(tileBytes());
+        if (slot.buffer.size() != tileBytes()) {
+            // 读取失败：按墙壁处理并记录错误；不缓存、也不作为快速路径的块，下次访问重新读取
+            ++counters.ioErrors;
+            release(slot);
+            freeSlots.push_back(s);
+            if (wallTile.size() != tileBytes())
+                wallTile.fill(static_cast<char>(0xFF), tileBytes());
+            lastTile = -1;
+            lastData = reinterpret_cast<const uchar *>(wallTile.constData());
+            return;
+        }
+        slot.data = reinterpret_cast<const uchar *>(slot.buffer.constData());
+    }
+    lru.push_front(s);
+    slot.position = lru.begin();
+    where[index] = s;
+
+    ++counters.faults;
+    counters.bytesRead += tileBytes();
+    counters.peakResident = qMax(counters.peakResident, static_cast<int>(lru.size()));
+    lastTile = index;
+    lastData = slot.data;
+}
+
+bool TiledGrid::writeTiles(const MazeView &view, const QString &filePath, int tileSize, QString *error) {
+    if (!validTileSize(tileSize))
+        return failWith(error, "块边长必须是 16 到 4096 之间 8 的倍数。");
+    if (view.rows <= 0 || view.cols <= 0)
+        return failWith(error, "迷宫为空。");
+
+    QFile out(filePath);
+    if (!createTileFile(out, error)) return false;
+    TileWriter writer(out, view.cols, tileSize);
+    for (int y = 0; y < view.rows; ++y)
+        if (!writer.appendRow([&](int x) { return !view.isOpen(x, y); }))
+            return failWith(error, "写入分块文件失败。");
+    if (!writer.finish())
+        return failWith(error, "写入分块文件失败。");
+    return true;
+}
+
+bool TiledGrid::convertText(const QString &textPath, const QString &filePath, int tileSize,
+                            QString *error, int *rows, int *cols) {
+    if (!validTileSize(tileSize))
+        return failWith(error, "块边长必须是 16 到 4096 之间 8 的倍数。");
+
+    QFile in(textPath);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Text))
+        return failWith(error, "无法打开迷宫文本文件。");
+    QTextStream text(&in);
+
+    QFile out(filePath);
+    if (!createTileFile(out, error)) return false;
+
+    // 第一行确定列数，之后逐行转换，一次只保留一行文本和一行块
+    QString line = text.readLine().trimmed();
+    if (line.isEmpty())
+        return failWith(error, "文件为空。");
+    const int c = static_cast<int>(line.length());
+    TileWriter writer(out, c, tileSize);
+    for (;;) {
+        if (line.length() != c)
+            return failWith(error, QString("文件格式不正确：第 %1 行长度不一致。").arg(writer.rowCount() + 1));
+        for (int x = 0; x < c; ++x)
+            if (line[x] != '0' && line[x] != '1')
+                return failWith(error, QString("文件格式不正确：包含非法字符 '%1'。").arg(line[x]));
+        if (!writer.appendRow([&](int x) { return line[x] == '1'; }))
+            return failWith(error, "写入分块文件失败。");
+        if (text.atEnd()) break;
+        line = text.readLine().trimmed();
+    }
+
+    if (!writer.finish())
+        return failWith(error, "写入分块文件失败。");
+    if (rows) *rows = writer.rowCount();
+    if (cols) *cols = c;
+    return true;
+}
@@ -0,0 +1,122 @@
+#ifndef TILEDGRID_H
+#define TILEDGRID_H
+
+#include "mazegrid.h"
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+#include <list>          // std::list
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+// 分块存储在磁盘上的迷宫网格，用于内存放不下的超大地图
+//
+// 文件格式（.mzt）：
+//   文件头 kHeaderBytes 字节：8 字节魔数 "MZTILES1"，随后是小端序 quint32 的行数、列数、块边长，其余补 0；
+//   之后按行优先顺序依次存放各个块，每块 块边长 x 块边长 个单元格，每个单元格 1 位（1-墙壁，0-通路），
+//   块内第 ly 行第 lx 列位于第 (ly * 块边长 + lx) / 8 字节的第 (lx % 8) 位；超出地图的部分按墙壁填充。
+//
+// 打开后按需把块映射到内存（QFile::map，失败时退回普通读取），常驻的块数不超过 maxResidentTiles，
+// 超出时按最近最少使用（LRU）淘汰，因此常驻内存有上界，与地图大小无关。
+// 映射和读取都失败的块按墙壁处理且不进入缓存，每次访问都重新读取并计入 Stats::ioErrors，
+// 调用方据此区分"读不到地图"和"确实不连通"。
+// 读取单元格会改变缓存状态，所以不是 const，也不能在多个线程间共享。
+class TiledGrid
+{
+public:
+    static const int kHeaderBytes = 4096;   // 文件头大小，使各块按页对齐
+    static const int kDefaultTileSize = 256; // 默认块边长：每块 8 KB
+    static const int kDefaultMaxTiles = 64;  // 默认最多常驻 64 块
+
+    // 缓存统计
+    struct Stats {
+        qint64 lookups = 0;   // 跨块访问次数（连续访问同一块时不计）
+        qint64 faults = 0;    // 块不在缓存中、需要从文件映射/读取的次数
+        qint64 evictions = 0; // 因缓存已满而淘汰的块数
+        qint64 bytesRead = 0; // 从文件映射/读取的字节数
+        int peakResident = 0; // 同时常驻的最大块数
+        qint64 ioErrors = 0;  // 块映射和读取都失败的次数
+    };
+
+    TiledGrid() = default;
+    ~TiledGrid();
+    TiledGrid(const TiledGrid &) = delete;
+    TiledGrid &operator=(const TiledGrid &) = delete;
+
+    // 打开分块文件，失败时返回 false，并在 error 中给出原因
+    bool open(const QString &filePath, int maxResidentTiles = kDefaultMaxTiles, QString *error = nullptr);
+    void close();
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int tileSize() const { return tileEdge; }
+    int tilesX() const { return tileCols; }
+    qint64 tileBytes() const { return static_cast<qint64>(tileEdge) * tileEdge / 8; }
+    int maxResidentTiles() const { return static_cast<int>(slots.size()); }
+    qint64 residentBytes() const { return static_cast<qint64>(lru.size()) * tileBytes(); }
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < colCount && y >= 0 && y < rowCount; }
+    bool inBounds(const QPoint &p) const { return inBounds(p.x(), p.y()); }
+
+    // 是否为可通行单元格（越界视为不可通行）；连续访问同一块时不查缓存表
+    bool isOpen(int x, int y) {
+        if (!inBounds(x, y)) return false;
+        const qint64 t = tileIndex(x, y);
+        if (t != lastTile)
+            tile(t);
+        const int lx = x % tileEdge;
+        const int bit = (y % tileEdge) * tileEdge + lx;
+        return ((lastData[bit >> 3] >> (lx & 7)) & 1) == 0;
+    }
+    bool isOpen(const QPoint &p) { return isOpen(p.x(), p.y()); }
+
+    // 单元格所在块的编号（行优先）
+    qint64 tileIndex(int x, int y) const {
+        return static_cast<qint64>(y / tileEdge) * tileCols + x / tileEdge;
+    }
+
+    const Stats &stats() const { return counters; }
+    void resetStats();
+
+    // 把内存中的迷宫写成分块文件
+    static bool writeTiles(const MazeView &view, const QString &filePath,
+                           int tileSize = kDefaultTileSize, QString *error = nullptr);
+
+    // 把迷宫文本文件（格式见 mazeio.h）流式转换为分块文件：
+    // 每次只缓存一行块（块边长行），不需要把整个地图读入内存
+    static bool convertText(const QString &textPath, const QString &filePath, int tileSize = kDefaultTileSize,
+                            QString *error = nullptr, int *rows = nullptr, int *cols = nullptr);
+
+private:
+    // 一个缓存槽：映射成功时 data 指向映射区，否则指向 buffer
+    struct Slot {
+        qint64 tile = -1;
+        uchar *mapped = nullptr;
+        QByteArray buffer;
+        const uchar *data = nullptr;
+        std::list<int>::iterator position; // 在 lru 中的位置
+    };
+
+    void tile(qint64 index); // 把块数据设为 lastData，不在缓存中时映射/读取
+    void release(Slot &slot);
+
+    QFile file;
+    int rowCount = 0;
+    int colCount = 0;
+    int tileEdge = kDefaultTileSize;
+    int tileCols = 0;
+
+    std::vector<Slot> slots;
+    std::list<int> lru;                     // 常驻块所在的槽，表头为最近使用
+    std::unordered_map<qint64, int> where;  // 块编号 -> 槽
+    std::vector<int> freeSlots;
+    qint64 lastTile = -1;                   // 最近访问的块，isOpen 的快速路径；读取失败时为 -1
+    const uchar *lastData = nullptr;
+    QByteArray wallTile;                    // 读取失败时代替块数据，全部为墙壁
+
+    Stats counters;
+};
+
+#endif // TILEDGRID_H
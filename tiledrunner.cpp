@@ -0,0 +1,238 @@
+#include "tiledrunner.h"
+
+#include "compactpath.h"
+#include "jsonlines.h"
+#include "mazegenerator.h"
+#include "mazegrid.h"
+#include "mazeio.h"
+#include "pagedsolver.h"
+#include "pathsolver.h"
+#include "tiledgrid.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+const char *const TiledRunner::kFlag = "--tiled";
+
+namespace {
+
+const int kDefaultSearchMb = 256; // 未指定 --max-nodes 时每次搜索状态的默认内存预算（MB）
+
+// --generate 先在内存中生成整个迷宫（每个单元格一个 int）再写成分块文件，只适合小地图；
+// 超过这个单元格数时应先生成文本文件，再用 --convert 流式转换
+const qint64 kMaxGenerateCells = 4096LL * 4096;
+
+// 随机取一个通路单元格：地图可能放不下内存，不能先列出全部通路，改为随机试探
+bool randomOpenCell(TiledGrid &grid, QRandomGenerator &rng, QPoint &cell) {
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const QPoint p(static_cast<int>(rng.bounded(static_cast<quint32>(grid.cols()))),
+                       static_cast<int>(rng.bounded(static_cast<quint32>(grid.rows()))));
+        if (grid.isOpen(p)) {
+            cell = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int TiledRunner::run(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("分块地图模式：地图按块存放在磁盘上，按需换入，结果以 JSON Lines 格式输出到标准输出。");
+    parser.addHelpOption();
+
+    QCommandLineOption tiledOption("tiled", "进入分块地图模式（必须）。");
+    QCommandLineOption mapOption("map", "分块地图文件（必须）。指定 --convert/--generate 时为输出文件。", "file");
+    QCommandLineOption convertOption("convert", "把迷宫文本文件转换为分块地图（流式转换，不整体读入内存）。", "file");
+    QCommandLineOption generateOption("generate", "生成 <行数>x<列数> 的迷宫并写成分块地图。迷宫先整体生成在内存中，"
+                                                  "只用于不超过 4096x4096 个单元格的小地图，大地图请用 --convert。", "RxC");
+    QCommandLineOption seedOption("seed", "迷宫生成和随机查询的种子。", "n", "1");
+    QCommandLineOption tileSizeOption("tile-size", "转换/生成时的块边长（8 的倍数）。", "n",
+                                      QString::number(TiledGrid::kDefaultTileSize));
+    QCommandLineOption maxTilesOption("max-tiles", "最多同时常驻内存的块数。", "n",
+                                      QString::number(TiledGrid::kDefaultMaxTiles));
+    QCommandLineOption searchMbOption("search-mb", "每次搜索的搜索状态（哈希表和开放列表）内存预算，单位 MB，用于换算 --max-nodes 的默认值。",
+                                      "n", QString::number(kDefaultSearchMb));
+    QCommandLineOption maxNodesOption("max-nodes", "每次搜索记录的单元格数与开放列表元素数之和的上限，0 表示不限制；默认由 --search-mb 换算。", "n");
+    QCommandLineOption queriesOption("queries", "查询文件，每行 \"sx sy ex ey\"；\"-\" 表示标准输入。", "file");
+    QCommandLineOption randomOption("random-queries", "没有查询文件时随机生成的查询数。", "n", "100");
+    QCommandLineOption neighborhoodOption("neighborhood", "邻域：4 或 8。", "4|8", "4");
+    QCommandLineOption heuristicOption("heuristic", "启发函数：manhattan、octile 或 zero；8 邻域下 manhattan 改用 octile。", "name", "manhattan");
+    QCommandLineOption pathsOption("paths", "在结果中输出路径的方向编码串。");
+    parser.addOptions({tiledOption, mapOption, convertOption, generateOption, seedOption, tileSizeOption,
+                       maxTilesOption, searchMbOption, maxNodesOption, queriesOption, randomOption, neighborhoodOption,
+                       heuristicOption, pathsOption});
+    parser.process(arguments);
+
+    if (!parser.isSet(mapOption))
+        return failWith("需要用 --map 指定分块地图文件。");
+    const QString mapFile = parser.value(mapOption);
+
+    SolverOptions options;
+    if (!parseNeighborhood(parser.value(neighborhoodOption), options.neighborhood))
+        return failWith("--neighborhood 只能是 4 或 8。");
+    if (!parseHeuristic(parser.value(heuristicOption), options.heuristic))
+        return failWith("--heuristic 只能是 manhattan、octile 或 zero。");
+    options = admissibleOptions(options);
+    const quint32 seed = parser.value(seedOption).toUInt();
+    const bool printPaths = parser.isSet(pathsOption);
+
+    // ---------- 生成分块地图 ----------
+    QElapsedTimer timer;
+    timer.start();
+    if (parser.isSet(convertOption) || parser.isSet(generateOption)) {
+        const int tileSize = parser.value(tileSizeOption).toInt();
+        QString error;
+        QJsonObject info;
+        info["type"] = "convert";
+        if (parser.isSet(convertOption)) {
+            int r = 0, c = 0;
+            if (!TiledGrid::convertText(parser.value(convertOption), mapFile, tileSize, &error, &r, &c))
+                return failWith(error);
+            info["source"] = parser.value(convertOption);
+            info["rows"] = r;
+            info["cols"] = c;
+        } else {
+            int r = 0, c = 0;
+            if (!parseMazeSize(parser.value(generateOption), r, c))
+                return failWith("--generate 的格式应为 <行数>x<列数>，且都不小于 3。");
+            if (static_cast<qint64>(r) * c > kMaxGenerateCells)
+                return failWith("--generate 最多生成 4096x4096 个单元格，更大的地图请用 --convert 转换迷宫文本文件。");
+            MazeGrid grid;
+            grid.resize(r, c);
+            MazeGenerator::generate(grid.data(), r, c, c, seed, 0);
+            if (!TiledGrid::writeTiles(grid.view(), mapFile, tileSize, &error))
+                return failWith(error);
+            info["source"] = "generate";
+            info["seed"] = static_cast<qint64>(seed);
+            info["rows"] = r;
+            info["cols"] = c;
+        }
+        info["map"] = mapFile;
+        info["ms"] = timer.nsecsElapsed() / 1e6;
+        emitLine(info);
+    }
+
+    // ---------- 打开分块地图 ----------
+    TiledGrid grid;
+    QString error;
+    if (!grid.open(mapFile, qMax(1, parser.value(maxTilesOption).toInt()), &error))
+        return failWith(error);
+    QJsonObject mapInfo;
+    mapInfo["type"] = "map";
+    mapInfo["rows"] = grid.rows();
+    mapInfo["cols"] = grid.cols();
+    mapInfo["tileSize"] = grid.tileSize();
+    mapInfo["tileBytes"] = grid.tileBytes();
+    mapInfo["maxTiles"] = grid.maxResidentTiles();
+    mapInfo["cacheBytes"] = grid.tileBytes() * grid.maxResidentTiles();
+
+    // 搜索状态的上限：未指定 --max-nodes 时由内存预算换算，保证单次搜索的内存也有上界
+    PagedWorkspace ws;
+    if (parser.isSet(maxNodesOption)) {
+        bool ok = false;
+        ws.nodeLimit = parser.value(maxNodesOption).toLongLong(&ok);
+        if (!ok || ws.nodeLimit < 0)
+            return failWith("--max-nodes 必须是非负整数。");
+    } else {
+        ws.nodeLimit = PagedWorkspace::nodeLimitFor(qMax(1LL, parser.value(searchMbOption).toLongLong()) * 1024 * 1024);
+    }
+    mapInfo["maxNodes"] = ws.nodeLimit;
+    emitLine(mapInfo);
+
+    QVector<Query> queries;
+    if (parser.isSet(queriesOption)) {
+        if (!readQueries(parser.value(queriesOption), queries, error))
+            return failWith(error);
+    } else {
+        QRandomGenerator rng(seed);
+        const int count = parser.value(randomOption).toInt();
+        for (int i = 0; i < count; ++i) {
+            Query q;
+            if (!randomOpenCell(grid, rng, q.start) || !randomOpenCell(grid, rng, q.end))
+                return failWith("地图中找不到通路单元格。");
+            queries.append(q);
+        }
+    }
+
+    // ---------- 求解 ----------
+    // 块缓存不能在线程间共享，查询逐个求解；统计从这里开始计，不含生成随机查询时的读取
+    grid.resetStats();
+    timer.restart();
+    qint64 found = 0, invalid = 0, limited = 0, ioErrors = 0, expandedTotal = 0, peakStateBytes = 0;
+    for (int i = 0; i < queries.size(); ++i) {
+        const TiledGrid::Stats before = grid.stats();
+        QElapsedTimer t;
+        t.start();
+        CompactPath path;
+        // 与 --batch 相同：起点或终点越界或是墙壁的查询不搜索，记为 invalid 而不算作不连通
+        const bool valid = grid.isOpen(queries[i].start) && grid.isOpen(queries[i].end);
+        bool ok = valid && findPathTiled(grid, queries[i].start, queries[i].end, options, ws, path);
+        if (!valid) ws.reset();
+        const qint64 elapsedNs = t.nsecsElapsed();
+        // 读不到的块被当成墙壁，这时的结果（包括找到的路径是否最短、端点是否有效）都不可信，单独报告
+        const bool ioError = grid.stats().ioErrors != before.ioErrors;
+        if (ioError) ok = false;
+
+        QJsonObject line;
+        line["type"] = "result";
+        line["id"] = i;
+        line["start"] = pointJson(queries[i].start);
+        line["end"] = pointJson(queries[i].end);
+        line["found"] = ok;
+        if (ioError) {
+            line["ioError"] = true;
+            ++ioErrors;
+        } else if (!valid) {
+            line["invalid"] = true;
+            ++invalid;
+        } else if (ws.limited) {
+            line["limited"] = true;
+            ++limited;
+        }
+        if (ok) {
+            line["steps"] = path.steps();
+            line["cost"] = static_cast<double>(pathCost(path)) / kStraightCost; // 直行一步为 1
+            if (printPaths)
+                line["moves"] = path.codeString();
+            ++found;
+        }
+        line["expanded"] = ws.expanded;
+        line["nodes"] = static_cast<qint64>(ws.nodes.size());
+        line["stateBytes"] = ws.stateBytes();
+        line["faults"] = grid.stats().faults - before.faults;
+        line["readBytes"] = grid.stats().bytesRead - before.bytesRead;
+        line["us"] = elapsedNs / 1000.0;
+        emitLine(line);
+        expandedTotal += ws.expanded;
+        peakStateBytes = qMax(peakStateBytes, ws.stateBytes());
+    }
+
+    const double totalMs = timer.nsecsElapsed() / 1e6;
+    const TiledGrid::Stats &s = grid.stats();
+    QJsonObject stats;
+    stats["type"] = "stats";
+    stats["queries"] = static_cast<int>(queries.size());
+    stats["found"] = found;
+    stats["unreachable"] = static_cast<qint64>(queries.size()) - found - invalid - limited - ioErrors;
+    stats["invalid"] = invalid;
+    stats["limited"] = limited;
+    stats["ioErrors"] = ioErrors;
+    stats["tileReadErrors"] = s.ioErrors;
+    stats["expanded"] = expandedTotal;
+    stats["tileLookups"] = s.lookups;
+    stats["tileFaults"] = s.faults;
+    stats["evictions"] = s.evictions;
+    stats["hitRate"] = s.lookups > 0 ? 1.0 - static_cast<double>(s.faults) / s.lookups : 1.0;
+    stats["readBytes"] = s.bytesRead;
+    stats["peakResidentTiles"] = s.peakResident;
+    stats["peakResidentBytes"] = s.peakResident * grid.tileBytes();
+    stats["peakStateBytes"] = peakStateBytes; // 搜索状态在一个查询结束时最大（只增不减），取各查询的最大值
+    stats["totalMs"] = totalMs;
+    stats["qps"] = totalMs > 0 ? queries.size() / (totalMs / 1000.0) : 0.0;
+    emitLine(stats);
+    return 0;
+}
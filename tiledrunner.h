@@ -0,0 +1,22 @@
+#ifndef TILEDRUNNER_H
+#define TILEDRUNNER_H
+
+#include <QStringList>
+
+// 分块地图命令行模式
+// 用法：Mazerobot --tiled --map <文件.mzt> [选项]
+// 用 --convert <文本文件>（流式转换）或 --generate <行数>x<列数>（在内存中生成，仅限小地图）先生成分块文件（格式见 tiledgrid.h），
+// 再通过有上限的块缓存求解查询文件中的起终点对；输出格式与 --batch 相同（JSON Lines），
+// 每个结果额外给出块缺失次数、读取的字节数和搜索状态的字节数；端点越界或是墙壁的查询标记为 invalid，
+// 读不到地图块的查询标记为 ioError；最后一行给出缓存的汇总统计。
+class TiledRunner
+{
+public:
+    // 命令行中出现该参数时进入分块地图模式
+    static const char *const kFlag;
+
+    // 运行，返回进程退出码
+    static int run(const QStringList &arguments);
+};
+
+#endif // TILEDRUNNER_H